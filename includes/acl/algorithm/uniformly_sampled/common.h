@@ -64,6 +64,7 @@ namespace acl
 				uint32_t				sample_rate;								// TODO: Store duration as float instead
 
 				PtrOffset16<SegmentHeader>	segment_headers_offset;
+				PtrOffset16<uint32_t>		segment_start_indices_offset;			// Clip sample index of the first sample of every segment
 				PtrOffset16<uint32_t>		default_tracks_bitset_offset;
 				PtrOffset16<uint32_t>		constant_tracks_bitset_offset;
 				PtrOffset16<uint8_t>		constant_track_data_offset;
@@ -74,6 +75,9 @@ namespace acl
 				SegmentHeader*			get_segment_headers()		{ return segment_headers_offset.add_to(this); }
 				const SegmentHeader*	get_segment_headers() const	{ return segment_headers_offset.add_to(this); }
 
+				uint32_t*		get_segment_start_indices()			{ return segment_start_indices_offset.add_to(this); }
+				const uint32_t*	get_segment_start_indices() const	{ return segment_start_indices_offset.add_to(this); }
+
 				uint32_t*		get_default_tracks_bitset()			{ return default_tracks_bitset_offset.add_to(this); }
 				const uint32_t*	get_default_tracks_bitset() const	{ return default_tracks_bitset_offset.add_to(this); }
 
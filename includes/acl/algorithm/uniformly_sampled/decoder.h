@@ -29,11 +29,14 @@
 #include "acl/core/range_reduction_types.h"
 #include "acl/math/quat_32.h"
 #include "acl/math/vector4_32.h"
+#include "acl/math/transform_32.h"
 #include "acl/math/quat_packing.h"
 #include "acl/algorithm/uniformly_sampled/common.h"
 #include "acl/decompression/output_writer.h"
+#include "acl/decompression/default_output_writer.h"
 
 #include <stdint.h>
+#include <algorithm>
 
 //////////////////////////////////////////////////////////////////////////
 // See encoder for details
@@ -43,6 +46,14 @@ namespace acl
 {
 	namespace uniformly_sampled
 	{
+		// How poses are sampled between the key frames surrounding the sample time
+		enum class SamplingMode8 : uint8_t
+		{
+			Linear		= 0,	// Interpolates linearly between both key frames
+			Floor		= 1,	// Uses the key frame at or before the sample time
+			Nearest		= 2,	// Uses the key frame closest to the sample time
+		};
+
 		// 2 ways to encore a track as default: a bitset or omit the track
 		// the second method requires a track id to be present to distinguish the
 		// remaining tracks.
@@ -62,28 +73,36 @@ namespace acl
 
 		namespace impl
 		{
-			// TODO: Add a platform define or constant for the cache line size
-			static constexpr size_t CONTEXT_ALIGN_AS = 64;
+			static constexpr size_t CONTEXT_ALIGN_AS = CACHE_LINE_SIZE;
 
-			struct alignas(CONTEXT_ALIGN_AS) DecompressionContext
+			// Read-only state of a clip, it is never written once initialized
+			struct alignas(CONTEXT_ALIGN_AS) ClipDecompressionContext
 			{
-				// Read-only data
 				const SegmentHeader* segment_headers;
+				const uint32_t* segment_start_indices;
 
 				const uint32_t* constant_tracks_bitset;
 				const uint8_t* constant_track_data;
 				const uint32_t* default_tracks_bitset;
 
+				// Every segment but the last holds the same number of samples, except the first few which hold one more
+				uint32_t segment_num_samples;
+				uint32_t num_larger_segments;
+
 				const uint8_t* clip_range_data;
 
-				const uint8_t* format_per_track_data0;
-				const uint8_t* format_per_track_data1;
+				// Optional decode plan, see build_decode_plan(..)
+				const uint16_t* decode_plan;
 
-				const uint8_t* segment_range_data0;
-				const uint8_t* segment_range_data1;
+				// Optional constant track cache, see build_constant_track_cache(..)
+				const Quat_32* constant_rotations;
+				const Vector4_32* constant_translations;
+				uint16_t num_constant_cached_bones;
 
-				const uint8_t* animated_track_data0;
-				const uint8_t* animated_track_data1;
+				uint16_t num_default_rotations;
+				uint16_t num_default_translations;
+				uint16_t num_constant_tracks;
+				uint16_t num_animated_tracks;
 
 				uint32_t bitset_size;
 				uint8_t num_rotation_components;
@@ -91,9 +110,28 @@ namespace acl
 				float clip_duration;
 
 				bool has_mixed_packing;
+			};
+
+			// Sampling state, written by every seek and while decompressing
+			struct alignas(CONTEXT_ALIGN_AS) DecompressionContext
+			{
+				const ClipDecompressionContext* clip_context;
+
+				const uint8_t* format_per_track_data0;
+				const uint8_t* format_per_track_data1;
+
+				const uint8_t* segment_range_data0;
+				const uint8_t* segment_range_data1;
+
+				const uint8_t* animated_track_data0;
+				const uint8_t* animated_track_data1;
 
-				// Read-write data
-				alignas(CONTEXT_ALIGN_AS) uint32_t constant_track_offset;
+				// Optional key frame cache, see update_key_frame_cache(..)
+				Quat_32* key_frame_cache_rotations;
+				Vector4_32* key_frame_cache_translations;
+				uint16_t num_cached_bones;
+
+				uint32_t constant_track_offset;
 				uint32_t constant_track_data_offset;
 				uint32_t default_track_offset;
 				uint32_t clip_range_data_offset;
@@ -107,10 +145,47 @@ namespace acl
 				uint32_t key_frame_bit_offset1;
 
 				float interpolation_alpha;
+
+				// Playback cursor, the key frames and segments of the last seek
+				uint32_t key_frame0;
+				uint32_t key_frame1;
+				uint32_t segment_index0;
+				uint32_t segment_index1;
+				uint32_t pose_key_frame_bit_offset0;
+				uint32_t pose_key_frame_bit_offset1;
+
+				// Key frames held by the key frame cache
+				uint32_t cached_key_frame0;
+				uint32_t cached_key_frame1;
+			};
+
+			// A context allocated by allocate_decompression_context(..) owns the state of its clip
+			struct OwningDecompressionContext : public DecompressionContext
+			{
+				ClipDecompressionContext owned_clip_context;
+			};
+
+			// The context offsets at the start of a bone that do not depend on the segment or the key frames
+			struct BoneMaskEntry
+			{
+				uint16_t bone_index;
+				uint16_t num_preceding_variable_tracks;
+
+				uint32_t constant_track_data_offset;
+				uint32_t clip_range_data_offset;
+				uint32_t segment_range_data_offset;
+				uint32_t preceding_fixed_tracks_size;
+			};
+
+			struct BoneMask
+			{
+				const uint32_t* constant_tracks_bitset;		// Identifies the clip the mask was built for
+				BoneMaskEntry* entries;
+				uint16_t num_entries;
 			};
 
 			template<class SettingsType>
-			inline void initialize_context(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			inline void initialize_clip_context(const SettingsType& settings, const ClipHeader& header, ClipDecompressionContext& clip_context)
 			{
 				const RotationFormat8 rotation_format = settings.get_rotation_format(header.rotation_format);
 				const VectorFormat8 translation_format = settings.get_translation_format(header.translation_format);
@@ -137,13 +212,48 @@ namespace acl
 				}
 #endif
 
-				context.clip_duration = float(header.num_samples - 1) / float(header.sample_rate);
-				context.segment_headers = header.get_segment_headers();
-				context.default_tracks_bitset = header.get_default_tracks_bitset();
+				clip_context.clip_duration = float(header.num_samples - 1) / float(header.sample_rate);
+				clip_context.segment_headers = header.get_segment_headers();
+				clip_context.segment_start_indices = header.get_segment_start_indices();
+				clip_context.default_tracks_bitset = header.get_default_tracks_bitset();
+
+				// The leftover samples of the clip are spread over the first segments, one each
+				if (header.num_segments > 1)
+				{
+					const uint32_t last_segment_index = header.num_segments - 1;
+					clip_context.segment_num_samples = clip_context.segment_headers[last_segment_index - 1].num_samples;
+					clip_context.num_larger_segments = clip_context.segment_start_indices[last_segment_index] - (last_segment_index * clip_context.segment_num_samples);
+				}
+				else
+				{
+					clip_context.segment_num_samples = clip_context.segment_headers[0].num_samples;
+					clip_context.num_larger_segments = 0;
+				}
+
+				clip_context.constant_tracks_bitset = header.get_constant_tracks_bitset();
+				clip_context.constant_track_data = header.get_constant_track_data();
+				clip_context.clip_range_data = header.get_clip_range_data();
 
-				context.constant_tracks_bitset = header.get_constant_tracks_bitset();
-				context.constant_track_data = header.get_constant_track_data();
-				context.clip_range_data = header.get_clip_range_data();
+				clip_context.decode_plan = nullptr;
+				clip_context.constant_rotations = nullptr;
+				clip_context.constant_translations = nullptr;
+				clip_context.num_constant_cached_bones = 0;
+				clip_context.num_default_rotations = 0;
+				clip_context.num_default_translations = 0;
+				clip_context.num_constant_tracks = 0;
+				clip_context.num_animated_tracks = 0;
+
+				clip_context.bitset_size = get_bitset_size(header.num_bones * Constants::NUM_TRACKS_PER_BONE);
+				clip_context.num_rotation_components = rotation_format == RotationFormat8::Quat_128 ? 4 : 3;
+
+				// If all tracks are variable, no need for any extra padding except at the very end of the data
+				// If our tracks are mixed variable/not variable, we need to add some padding to ensure alignment
+				clip_context.has_mixed_packing = is_rotation_format_variable(rotation_format) != is_vector_format_variable(translation_format);
+			}
+
+			inline void initialize_context(const ClipDecompressionContext& clip_context, DecompressionContext& context)
+			{
+				context.clip_context = &clip_context;
 
 				context.format_per_track_data0 = nullptr;
 				context.format_per_track_data1 = nullptr;
@@ -154,12 +264,9 @@ namespace acl
 				context.animated_track_data0 = nullptr;
 				context.animated_track_data1 = nullptr;
 
-				context.bitset_size = get_bitset_size(header.num_bones * Constants::NUM_TRACKS_PER_BONE);
-				context.num_rotation_components = rotation_format == RotationFormat8::Quat_128 ? 4 : 3;
-
-				// If all tracks are variable, no need for any extra padding except at the very end of the data
-				// If our tracks are mixed variable/not variable, we need to add some padding to ensure alignment
-				context.has_mixed_packing = is_rotation_format_variable(rotation_format) != is_vector_format_variable(translation_format);
+				context.key_frame_cache_rotations = nullptr;
+				context.key_frame_cache_translations = nullptr;
+				context.num_cached_bones = 0;
 
 				context.constant_track_offset = 0;
 				context.constant_track_data_offset = 0;
@@ -167,805 +274,1679 @@ namespace acl
 				context.clip_range_data_offset = 0;
 				context.format_per_track_data_offset = 0;
 				context.segment_range_data_offset = 0;
+
+				// Invalidate the playback cursor, the first seek always searches for its segments
+				context.key_frame0 = 0xFFFFFFFF;
+				context.key_frame1 = 0xFFFFFFFF;
+				context.segment_index0 = 0xFFFFFFFF;
+				context.segment_index1 = 0xFFFFFFFF;
+				context.pose_key_frame_bit_offset0 = 0;
+				context.pose_key_frame_bit_offset1 = 0;
+
+				context.cached_key_frame0 = 0xFFFFFFFF;
+				context.cached_key_frame1 = 0xFFFFFFFF;
 			}
 
-			template<class SettingsType>
-			inline void seek(const SettingsType& settings, const ClipHeader& header, float sample_time, DecompressionContext& context)
+			// The decode plan lists, once per clip, which tracks are default, constant, and animated.
+			// It lets decompress_pose iterate over each group without testing the bitsets for every track.
+			// It is a single array partitioned as follows:
+			//    - Bone indices of the default rotations
+			//    - Bone indices of the default translations
+			//    - Track indices of the constant tracks, in track order
+			//    - Track indices of the animated tracks, in track order
+			// Constant and animated tracks must remain sorted since their data is read sequentially.
+			inline void build_decode_plan(Allocator& allocator, const ClipHeader& header, ClipDecompressionContext& clip_context)
 			{
-				context.constant_track_offset = 0;
-				context.constant_track_data_offset = 0;
-				context.default_track_offset = 0;
-				context.clip_range_data_offset = 0;
-				context.format_per_track_data_offset = 0;
-				context.segment_range_data_offset = 0;
+				const uint32_t num_tracks = header.num_bones * Constants::NUM_TRACKS_PER_BONE;
 
-				uint32_t key_frame0;
-				uint32_t key_frame1;
-				calculate_interpolation_keys(header.num_samples, context.clip_duration, sample_time, key_frame0, key_frame1, context.interpolation_alpha);
+				uint32_t num_default_rotations = 0;
+				uint32_t num_default_translations = 0;
+				uint32_t num_constant_tracks = 0;
+				uint32_t num_animated_tracks = 0;
 
-				uint32_t segment_key_frame0;
-				uint32_t segment_key_frame1;
-
-				// Find segments
-				// TODO: Use binary search?
-				uint32_t segment_key_frame = 0;
-				const SegmentHeader* segment_header0;
-				const SegmentHeader* segment_header1;
-				for (uint16_t segment_index = 0; segment_index < header.num_segments; ++segment_index)
+				for (uint32_t track_index = 0; track_index < num_tracks; ++track_index)
 				{
-					const SegmentHeader& segment_header = context.segment_headers[segment_index];
-
-					if (key_frame0 >= segment_key_frame && key_frame0 < segment_key_frame + segment_header.num_samples)
+					if (bitset_test(clip_context.default_tracks_bitset, clip_context.bitset_size, track_index))
 					{
-						segment_header0 = &segment_header;
-						segment_key_frame0 = key_frame0 - segment_key_frame;
-
-						if (key_frame1 >= segment_key_frame && key_frame1 < segment_key_frame + segment_header.num_samples)
-						{
-							segment_header1 = &segment_header;
-							segment_key_frame1 = key_frame1 - segment_key_frame;
-						}
+						if ((track_index % Constants::NUM_TRACKS_PER_BONE) == 0)
+							num_default_rotations++;
 						else
-						{
-							ACL_ENSURE(segment_index + 1 < header.num_segments, "Invalid segment index: %u", segment_index + 1);
-							const SegmentHeader& next_segment_header = context.segment_headers[segment_index + 1];
-							segment_header1 = &next_segment_header;
-							segment_key_frame1 = key_frame1 - (segment_key_frame + segment_header.num_samples);
-						}
-
-						break;
+							num_default_translations++;
 					}
-
-					segment_key_frame += segment_header.num_samples;
+					else if (bitset_test(clip_context.constant_tracks_bitset, clip_context.bitset_size, track_index))
+						num_constant_tracks++;
+					else
+						num_animated_tracks++;
 				}
 
-				context.format_per_track_data0 = header.get_format_per_track_data(*segment_header0);
-				context.format_per_track_data1 = header.get_format_per_track_data(*segment_header1);
-				context.segment_range_data0 = header.get_segment_range_data(*segment_header0);
-				context.segment_range_data1 = header.get_segment_range_data(*segment_header1);
-				context.animated_track_data0 = header.get_track_data(*segment_header0);
-				context.animated_track_data1 = header.get_track_data(*segment_header1);
-
-				context.key_frame_byte_offset0 = (segment_key_frame0 * segment_header0->animated_pose_bit_size) / 8;
-				context.key_frame_byte_offset1 = (segment_key_frame1 * segment_header1->animated_pose_bit_size) / 8;
-				context.key_frame_bit_offset0 = segment_key_frame0 * segment_header0->animated_pose_bit_size;
-				context.key_frame_bit_offset1 = segment_key_frame1 * segment_header1->animated_pose_bit_size;
-			}
+				uint16_t* decode_plan = allocate_type_array<uint16_t>(allocator, num_tracks);
+				uint16_t* default_rotations = decode_plan;
+				uint16_t* default_translations = default_rotations + num_default_rotations;
+				uint16_t* constant_tracks = default_translations + num_default_translations;
+				uint16_t* animated_tracks = constant_tracks + num_constant_tracks;
 
-			template<class SettingsType>
-			inline void skip_rotation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
-			{
-				bool is_rotation_default = bitset_test(context.default_tracks_bitset, context.bitset_size, context.default_track_offset);
-				if (!is_rotation_default)
+				for (uint32_t track_index = 0; track_index < num_tracks; ++track_index)
 				{
-					const RotationFormat8 rotation_format = settings.get_rotation_format(header.rotation_format);
+					const uint16_t bone_index = safe_static_cast<uint16_t>(track_index / Constants::NUM_TRACKS_PER_BONE);
 
-					bool is_rotation_constant = bitset_test(context.constant_tracks_bitset, context.bitset_size, context.constant_track_offset);
-					if (is_rotation_constant)
-					{
-						const RotationFormat8 packed_format = is_rotation_format_variable(rotation_format) ? get_highest_variant_precision(get_rotation_variant(rotation_format)) : rotation_format;
-						context.constant_track_data_offset += get_packed_rotation_size(packed_format);
-					}
-					else
+					if (bitset_test(clip_context.default_tracks_bitset, clip_context.bitset_size, track_index))
 					{
-						if (is_rotation_format_variable(rotation_format))
-						{
-							uint8_t bit_rate0 = context.format_per_track_data0[context.format_per_track_data_offset];
-							uint8_t bit_rate1 = context.format_per_track_data1[context.format_per_track_data_offset++];
-							uint8_t num_bits_at_bit_rate0 = get_num_bits_at_bit_rate(bit_rate0) * 3;	// 3 components
-							uint8_t num_bits_at_bit_rate1 = get_num_bits_at_bit_rate(bit_rate1) * 3;	// 3 components
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								num_bits_at_bit_rate0 = align_to(num_bits_at_bit_rate0, MIXED_PACKING_ALIGNMENT_NUM_BITS);
-								num_bits_at_bit_rate1 = align_to(num_bits_at_bit_rate1, MIXED_PACKING_ALIGNMENT_NUM_BITS);
-							}
-
-							context.key_frame_bit_offset0 += num_bits_at_bit_rate0;
-							context.key_frame_bit_offset1 += num_bits_at_bit_rate1;
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_byte_offset0 = context.key_frame_bit_offset0 / 8;
-								context.key_frame_byte_offset1 = context.key_frame_bit_offset1 / 8;
-							}
-						}
+						if ((track_index % Constants::NUM_TRACKS_PER_BONE) == 0)
+							*default_rotations++ = bone_index;
 						else
-						{
-							uint32_t rotation_size = get_packed_rotation_size(rotation_format);
-							context.key_frame_byte_offset0 += rotation_size;
-							context.key_frame_byte_offset1 += rotation_size;
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
-								context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
-							}
-						}
-
-						const RangeReductionFlags8 clip_range_reduction = settings.get_clip_range_reduction(header.clip_range_reduction);
-						const RangeReductionFlags8 segment_range_reduction = settings.get_segment_range_reduction(header.segment_range_reduction);
-						if (is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Rotations))
-							context.clip_range_data_offset += context.num_rotation_components * sizeof(float) * 2;
-
-						if (is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Rotations))
-							context.segment_range_data_offset += context.num_rotation_components * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
+							*default_translations++ = bone_index;
 					}
+					else if (bitset_test(clip_context.constant_tracks_bitset, clip_context.bitset_size, track_index))
+						*constant_tracks++ = safe_static_cast<uint16_t>(track_index);
+					else
+						*animated_tracks++ = safe_static_cast<uint16_t>(track_index);
 				}
 
-				context.default_track_offset++;
-				context.constant_track_offset++;
+				clip_context.decode_plan = decode_plan;
+				clip_context.num_default_rotations = safe_static_cast<uint16_t>(num_default_rotations);
+				clip_context.num_default_translations = safe_static_cast<uint16_t>(num_default_translations);
+				clip_context.num_constant_tracks = safe_static_cast<uint16_t>(num_constant_tracks);
+				clip_context.num_animated_tracks = safe_static_cast<uint16_t>(num_animated_tracks);
 			}
 
-			template<class SettingsType>
-			inline void skip_translation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			inline uint32_t get_decode_plan_size(const ClipDecompressionContext& clip_context)
 			{
-				bool is_translation_default = bitset_test(context.default_tracks_bitset, context.bitset_size, context.default_track_offset);
-				if (!is_translation_default)
-				{
-					bool is_translation_constant = bitset_test(context.constant_tracks_bitset, context.bitset_size, context.constant_track_offset);
-					if (is_translation_constant)
-					{
-						// Constant translation tracks store the remaining sample with full precision
-						context.constant_track_data_offset += get_packed_vector_size(VectorFormat8::Vector3_96);
-					}
-					else
-					{
-						const VectorFormat8 translation_format = settings.get_translation_format(header.translation_format);
+				return clip_context.num_default_rotations + clip_context.num_default_translations + clip_context.num_constant_tracks + clip_context.num_animated_tracks;
+			}
 
-						if (is_vector_format_variable(translation_format))
-						{
-							uint8_t bit_rate0 = context.format_per_track_data0[context.format_per_track_data_offset];
-							uint8_t bit_rate1 = context.format_per_track_data1[context.format_per_track_data_offset++];
-							uint8_t num_bits_at_bit_rate0 = get_num_bits_at_bit_rate(bit_rate0) * 3;	// 3 components
-							uint8_t num_bits_at_bit_rate1 = get_num_bits_at_bit_rate(bit_rate1) * 3;	// 3 components
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								num_bits_at_bit_rate0 = align_to(num_bits_at_bit_rate0, MIXED_PACKING_ALIGNMENT_NUM_BITS);
-								num_bits_at_bit_rate1 = align_to(num_bits_at_bit_rate1, MIXED_PACKING_ALIGNMENT_NUM_BITS);
-							}
-
-							context.key_frame_bit_offset0 += num_bits_at_bit_rate0;
-							context.key_frame_bit_offset1 += num_bits_at_bit_rate1;
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_byte_offset0 = context.key_frame_bit_offset0 / 8;
-								context.key_frame_byte_offset1 = context.key_frame_bit_offset1 / 8;
-							}
-						}
-						else
-						{
-							uint32_t translation_size = get_packed_vector_size(translation_format);
-							context.key_frame_byte_offset0 += translation_size;
-							context.key_frame_byte_offset1 += translation_size;
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
-								context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
-							}
-						}
+			// Prefetches what decompressing the pose reads right after seeking: both key frames, the segment
+			// format and range data, and the start of the constant and clip range data. Close to the end of
+			// a segment, the next one will be needed soon and its metadata is prefetched as well.
+			inline void prefetch_key_frames(const ClipHeader& header, const DecompressionContext& context)
+			{
+				const SegmentHeader& segment_header0 = context.clip_context->segment_headers[context.segment_index0];
+				const SegmentHeader& segment_header1 = context.clip_context->segment_headers[context.segment_index1];
 
-						const RangeReductionFlags8 clip_range_reduction = settings.get_clip_range_reduction(header.clip_range_reduction);
-						const RangeReductionFlags8 segment_range_reduction = settings.get_segment_range_reduction(header.segment_range_reduction);
-						if (is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Translations))
-							context.clip_range_data_offset += 3 * sizeof(float) * 2;
+				// A key frame rarely starts on a byte boundary, the bits before it in its first byte extend the range
+				memory_prefetch(context.animated_track_data0 + context.key_frame_byte_offset0, ((context.key_frame_bit_offset0 % 8) + segment_header0.animated_pose_bit_size + 7) / 8);
+				memory_prefetch(context.animated_track_data1 + context.key_frame_byte_offset1, ((context.key_frame_bit_offset1 % 8) + segment_header1.animated_pose_bit_size + 7) / 8);
 
-						if (is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Translations))
-							context.segment_range_data_offset += 3 * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
-					}
+				memory_prefetch(context.format_per_track_data0);
+				memory_prefetch(context.segment_range_data0);
+				if (context.segment_index1 != context.segment_index0)
+				{
+					memory_prefetch(context.format_per_track_data1);
+					memory_prefetch(context.segment_range_data1);
 				}
 
-				context.default_track_offset++;
-				context.constant_track_offset++;
+				memory_prefetch(context.clip_context->constant_track_data);
+				memory_prefetch(context.clip_context->clip_range_data);
+
+				const uint32_t next_segment_index = context.segment_index1 + 1;
+				if (next_segment_index < header.num_segments && context.key_frame1 + 1 >= context.clip_context->segment_start_indices[next_segment_index])
+				{
+					const SegmentHeader& next_segment_header = context.clip_context->segment_headers[next_segment_index];
+					memory_prefetch(header.get_format_per_track_data(next_segment_header));
+					memory_prefetch(header.get_segment_range_data(next_segment_header));
+					memory_prefetch(header.get_track_data(next_segment_header));
+				}
 			}
 
 			template<class SettingsType>
-			inline Quat_32 decompress_rotation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			inline void seek(const SettingsType& settings, const ClipHeader& header, float sample_time, DecompressionContext& context)
 			{
-				Quat_32 rotation;
+				context.constant_track_offset = 0;
+				context.constant_track_data_offset = 0;
+				context.default_track_offset = 0;
+				context.clip_range_data_offset = 0;
+				context.format_per_track_data_offset = 0;
+				context.segment_range_data_offset = 0;
 
-				bool is_rotation_default = bitset_test(context.default_tracks_bitset, context.bitset_size, context.default_track_offset);
-				if (is_rotation_default)
+				uint32_t key_frame0;
+				uint32_t key_frame1;
+				float interpolation_alpha;
+				calculate_interpolation_keys(header.num_samples, context.clip_context->clip_duration, sample_time, key_frame0, key_frame1, interpolation_alpha);
+
+				const SamplingMode8 sampling_mode = settings.get_sampling_mode();
+				if (sampling_mode != SamplingMode8::Linear)
 				{
-					rotation = quat_identity_32();
+					// A single key frame is sampled, both key frames are the same and there is nothing to interpolate
+					if (sampling_mode == SamplingMode8::Nearest && interpolation_alpha >= 0.5f)
+						key_frame0 = key_frame1;
+
+					key_frame1 = key_frame0;
+					interpolation_alpha = 0.0f;
 				}
-				else
-				{
-					const RotationFormat8 rotation_format = settings.get_rotation_format(header.rotation_format);
 
-					bool is_rotation_constant = bitset_test(context.constant_tracks_bitset, context.bitset_size, context.constant_track_offset);
-					if (is_rotation_constant)
-					{
-						const RotationFormat8 packed_format = is_rotation_format_variable(rotation_format) ? get_highest_variant_precision(get_rotation_variant(rotation_format)) : rotation_format;
+				context.interpolation_alpha = interpolation_alpha;
 
-						if (packed_format == RotationFormat8::Quat_128 && settings.is_rotation_format_supported(RotationFormat8::Quat_128))
-							rotation = unpack_quat_128(context.constant_track_data + context.constant_track_data_offset);
-						else if (packed_format == RotationFormat8::QuatDropW_96 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_96))
-							rotation = unpack_quat_96(context.constant_track_data + context.constant_track_data_offset);
-						else if (packed_format == RotationFormat8::QuatDropW_48 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_48))
-							rotation = unpack_quat_48(context.constant_track_data + context.constant_track_data_offset);
-						else if (packed_format == RotationFormat8::QuatDropW_32 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_32))
-							rotation = unpack_quat_32(context.constant_track_data + context.constant_track_data_offset);
+				if (settings.use_playback_cursor() && key_frame0 == context.key_frame0 && key_frame1 == context.key_frame1)
+				{
+					// Same key frames as the previous seek, only the interpolation alpha changed
+					context.key_frame_bit_offset0 = context.pose_key_frame_bit_offset0;
+					context.key_frame_bit_offset1 = context.pose_key_frame_bit_offset1;
+					context.key_frame_byte_offset0 = context.pose_key_frame_bit_offset0 / 8;
+					context.key_frame_byte_offset1 = context.pose_key_frame_bit_offset1 / 8;
+
+					if (settings.use_software_prefetching())
+						prefetch_key_frames(header, context);
+					return;
+				}
 
-						ACL_ENSURE(quat_is_finite(rotation), "Rotation is not valid!");
-						ACL_ENSURE(quat_is_normalized(rotation), "Rotation is not normalized!");
+				const uint32_t num_segments = header.num_segments;
+				const uint32_t* segment_start_indices = context.clip_context->segment_start_indices;
 
-						context.constant_track_data_offset += get_packed_rotation_size(packed_format);
-					}
+				// When both key frames remain within the single segment of the previous seek, its pointers are still valid
+				const uint32_t previous_segment_index = context.segment_index0;
+				const bool is_same_segment = settings.use_playback_cursor()
+					&& previous_segment_index == context.segment_index1
+					&& previous_segment_index < num_segments
+					&& key_frame0 >= segment_start_indices[previous_segment_index]
+					&& key_frame1 < segment_start_indices[previous_segment_index] + context.clip_context->segment_headers[previous_segment_index].num_samples;
+
+				if (!is_same_segment)
+				{
+					// Find segments
+					// The larger segments come first, the segment index follows directly from the segment sizes.
+					// The start indices only validate it, seeking is thus O(1) regardless of the clip length.
+					const uint32_t segment_num_samples = context.clip_context->segment_num_samples;
+					const uint32_t larger_segments_num_samples = context.clip_context->num_larger_segments * (segment_num_samples + 1);
+
+					uint32_t segment_index0;
+					if (key_frame0 < larger_segments_num_samples)
+						segment_index0 = key_frame0 / (segment_num_samples + 1);
 					else
-					{
-						const RangeReductionFlags8 clip_range_reduction = settings.get_clip_range_reduction(header.clip_range_reduction);
-						const RangeReductionFlags8 segment_range_reduction = settings.get_segment_range_reduction(header.segment_range_reduction);
-						const bool are_clip_rotations_normalized = is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Rotations);
-						const bool are_segment_rotations_normalized = is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Rotations);
+						segment_index0 = context.clip_context->num_larger_segments + ((key_frame0 - larger_segments_num_samples) / segment_num_samples);
 
-						Quat_32 rotation0;
-						Quat_32 rotation1;
+					segment_index0 = std::min<uint32_t>(segment_index0, num_segments - 1);
+					while (segment_index0 > 0 && key_frame0 < segment_start_indices[segment_index0])
+						segment_index0--;
+					while (segment_index0 + 1 < num_segments && key_frame0 >= segment_start_indices[segment_index0 + 1])
+						segment_index0++;
 
-						if (rotation_format == RotationFormat8::Quat_128 && settings.is_rotation_format_supported(RotationFormat8::Quat_128))
-						{
-							Vector4_32 rotation0_xyzw = unpack_vector4_128(context.animated_track_data0 + context.key_frame_byte_offset0);
-							Vector4_32 rotation1_xyzw = unpack_vector4_128(context.animated_track_data1 + context.key_frame_byte_offset1);
+					uint32_t segment_index1 = segment_index0;
+					if (segment_index1 + 1 < num_segments && key_frame1 >= segment_start_indices[segment_index1 + 1])
+						segment_index1++;
 
-							if (are_segment_rotations_normalized)
-							{
-#if ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BIT_SIZE == 8
-								Vector4_32 segment_range_min0 = unpack_vector4_32(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector4_32(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-								Vector4_32 segment_range_min1 = unpack_vector4_32(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector4_32(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-#else
-								Vector4_32 segment_range_min0 = unpack_vector4_64(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector4_64(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-								Vector4_32 segment_range_min1 = unpack_vector4_64(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector4_64(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-#endif
+					ACL_ENSURE(key_frame1 < segment_start_indices[segment_index1] + context.clip_context->segment_headers[segment_index1].num_samples, "Invalid segment index: %u", segment_index1);
 
-								rotation0_xyzw = vector_mul_add(rotation0_xyzw, segment_range_extent0, segment_range_min0);
-								rotation1_xyzw = vector_mul_add(rotation1_xyzw, segment_range_extent1, segment_range_min1);
+					const SegmentHeader& segment_header0 = context.clip_context->segment_headers[segment_index0];
+					const SegmentHeader& segment_header1 = context.clip_context->segment_headers[segment_index1];
 
-								context.segment_range_data_offset += context.num_rotation_components * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
-							}
+					context.format_per_track_data0 = header.get_format_per_track_data(segment_header0);
+					context.format_per_track_data1 = header.get_format_per_track_data(segment_header1);
+					context.segment_range_data0 = header.get_segment_range_data(segment_header0);
+					context.segment_range_data1 = header.get_segment_range_data(segment_header1);
+					context.animated_track_data0 = header.get_track_data(segment_header0);
+					context.animated_track_data1 = header.get_track_data(segment_header1);
 
-							if (are_clip_rotations_normalized)
-							{
-								Vector4_32 clip_range_min = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset);
-								Vector4_32 clip_range_extent = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset + (context.num_rotation_components * sizeof(float)));
+					context.segment_index0 = segment_index0;
+					context.segment_index1 = segment_index1;
+				}
 
-								rotation0_xyzw = vector_mul_add(rotation0_xyzw, clip_range_extent, clip_range_min);
-								rotation1_xyzw = vector_mul_add(rotation1_xyzw, clip_range_extent, clip_range_min);
+				const SegmentHeader& segment_header0 = context.clip_context->segment_headers[context.segment_index0];
+				const SegmentHeader& segment_header1 = context.clip_context->segment_headers[context.segment_index1];
+				const uint32_t segment_key_frame0 = key_frame0 - segment_start_indices[context.segment_index0];
+				const uint32_t segment_key_frame1 = key_frame1 - segment_start_indices[context.segment_index1];
 
-								context.clip_range_data_offset += context.num_rotation_components * sizeof(float) * 2;
-							}
+				context.key_frame0 = key_frame0;
+				context.key_frame1 = key_frame1;
+				context.pose_key_frame_bit_offset0 = segment_key_frame0 * segment_header0.animated_pose_bit_size;
+				context.pose_key_frame_bit_offset1 = segment_key_frame1 * segment_header1.animated_pose_bit_size;
 
-							rotation0 = vector_to_quat(rotation0_xyzw);
-							rotation1 = vector_to_quat(rotation1_xyzw);
+				context.key_frame_byte_offset0 = context.pose_key_frame_bit_offset0 / 8;
+				context.key_frame_byte_offset1 = context.pose_key_frame_bit_offset1 / 8;
+				context.key_frame_bit_offset0 = context.pose_key_frame_bit_offset0;
+				context.key_frame_bit_offset1 = context.pose_key_frame_bit_offset1;
 
-							const uint32_t rotation_size = get_packed_rotation_size(rotation_format);
-							context.key_frame_byte_offset0 += rotation_size;
-							context.key_frame_byte_offset1 += rotation_size;
+				if (settings.use_software_prefetching())
+					prefetch_key_frames(header, context);
+			}
 
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
-								context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
-							}
-						}
-						else if (rotation_format == RotationFormat8::QuatDropW_96 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_96))
-						{
-							Vector4_32 rotation0_xyz = unpack_vector3_96(context.animated_track_data0 + context.key_frame_byte_offset0);
-							Vector4_32 rotation1_xyz = unpack_vector3_96(context.animated_track_data1 + context.key_frame_byte_offset1);
+			// Rotation tracks are stored at even track indices which map to odd bits in every bitset word
+			static constexpr uint32_t ROTATION_TRACKS_BITSET_MASK = 0xAAAAAAAA;
+			static constexpr uint32_t TRANSLATION_TRACKS_BITSET_MASK = 0x55555555;
 
-							if (are_segment_rotations_normalized)
-							{
-#if ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BIT_SIZE == 8
-								Vector4_32 segment_range_min0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-								Vector4_32 segment_range_min1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-#else
-								Vector4_32 segment_range_min0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-								Vector4_32 segment_range_min1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-#endif
+			// Calculates the offsets of the first track of the provided bone that don't depend on the segment or the key frames.
+			// The default and constant tracks that precede the bone are counted with the bitsets instead of testing every track.
+			template<class SettingsType>
+			inline void calculate_bone_offsets(const SettingsType& settings, const ClipHeader& header, uint16_t bone_index, BoneMaskEntry& out_offsets)
+			{
+				const uint32_t track_index = bone_index * Constants::NUM_TRACKS_PER_BONE;
+				const uint32_t* default_tracks_bitset = header.get_default_tracks_bitset();
+				const uint32_t* constant_tracks_bitset = header.get_constant_tracks_bitset();
 
-								rotation0_xyz = vector_mul_add(rotation0_xyz, segment_range_extent0, segment_range_min0);
-								rotation1_xyz = vector_mul_add(rotation1_xyz, segment_range_extent1, segment_range_min1);
+				uint32_t num_default_rotations = 0;
+				uint32_t num_default_translations = 0;
+				uint32_t num_constant_rotations = 0;
+				uint32_t num_constant_translations = 0;
 
-								context.segment_range_data_offset += context.num_rotation_components * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
-							}
+				const uint32_t last_word_index = track_index / 32;
+				for (uint32_t word_index = 0; word_index <= last_word_index; ++word_index)
+				{
+					const uint32_t word_mask = word_index == last_word_index ? bitset_leading_bits_mask(track_index) : 0xFFFFFFFF;
+					const uint32_t default_tracks = default_tracks_bitset[word_index] & word_mask;
+					const uint32_t constant_tracks = constant_tracks_bitset[word_index] & word_mask & ~default_tracks;
+
+					num_default_rotations += count_set_bits(default_tracks & ROTATION_TRACKS_BITSET_MASK);
+					num_default_translations += count_set_bits(default_tracks & TRANSLATION_TRACKS_BITSET_MASK);
+					num_constant_rotations += count_set_bits(constant_tracks & ROTATION_TRACKS_BITSET_MASK);
+					num_constant_translations += count_set_bits(constant_tracks & TRANSLATION_TRACKS_BITSET_MASK);
+				}
 
-							if (are_clip_rotations_normalized)
-							{
-								Vector4_32 clip_range_min = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset);
-								Vector4_32 clip_range_extent = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset + (context.num_rotation_components * sizeof(float)));
+				const uint32_t num_animated_rotations = bone_index - num_default_rotations - num_constant_rotations;
+				const uint32_t num_animated_translations = bone_index - num_default_translations - num_constant_translations;
 
-								rotation0_xyz = vector_mul_add(rotation0_xyz, clip_range_extent, clip_range_min);
-								rotation1_xyz = vector_mul_add(rotation1_xyz, clip_range_extent, clip_range_min);
+				const RotationFormat8 rotation_format = settings.get_rotation_format(header.rotation_format);
+				const VectorFormat8 translation_format = settings.get_translation_format(header.translation_format);
+				const RangeReductionFlags8 clip_range_reduction = settings.get_clip_range_reduction(header.clip_range_reduction);
+				const RangeReductionFlags8 segment_range_reduction = settings.get_segment_range_reduction(header.segment_range_reduction);
+				const uint32_t num_rotation_components = rotation_format == RotationFormat8::Quat_128 ? 4 : 3;
 
-								context.clip_range_data_offset += context.num_rotation_components * sizeof(float) * 2;
-							}
+				// Constant rotation tracks use the highest precision of their variant, constant translation tracks use full precision
+				const RotationFormat8 packed_format = is_rotation_format_variable(rotation_format) ? get_highest_variant_precision(get_rotation_variant(rotation_format)) : rotation_format;
+				out_offsets.constant_track_data_offset = (num_constant_rotations * get_packed_rotation_size(packed_format)) + (num_constant_translations * get_packed_vector_size(VectorFormat8::Vector3_96));
 
-							rotation0 = quat_from_positive_w(rotation0_xyz);
-							rotation1 = quat_from_positive_w(rotation1_xyz);
+				out_offsets.clip_range_data_offset = 0;
+				if (is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Rotations))
+					out_offsets.clip_range_data_offset += num_animated_rotations * num_rotation_components * sizeof(float) * 2;
 
-							const uint32_t rotation_size = get_packed_rotation_size(rotation_format);
-							context.key_frame_byte_offset0 += rotation_size;
-							context.key_frame_byte_offset1 += rotation_size;
+				if (is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Translations))
+					out_offsets.clip_range_data_offset += num_animated_translations * 3 * sizeof(float) * 2;
 
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
-								context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
-							}
-						}
-						else if (rotation_format == RotationFormat8::QuatDropW_48 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_48))
-						{
-							Vector4_32 rotation0_xyz = unpack_vector3_48(context.animated_track_data0 + context.key_frame_byte_offset0, are_clip_rotations_normalized);
-							Vector4_32 rotation1_xyz = unpack_vector3_48(context.animated_track_data1 + context.key_frame_byte_offset1, are_clip_rotations_normalized);
+				out_offsets.segment_range_data_offset = 0;
+				if (is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Rotations))
+					out_offsets.segment_range_data_offset += num_animated_rotations * num_rotation_components * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
 
-							if (are_segment_rotations_normalized)
-							{
-#if ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BIT_SIZE == 8
-								Vector4_32 segment_range_min0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-								Vector4_32 segment_range_min1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-#else
-								Vector4_32 segment_range_min0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-								Vector4_32 segment_range_min1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-#endif
+				if (is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Translations))
+					out_offsets.segment_range_data_offset += num_animated_translations * 3 * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
 
-								rotation0_xyz = vector_mul_add(rotation0_xyz, segment_range_extent0, segment_range_min0);
-								rotation1_xyz = vector_mul_add(rotation1_xyz, segment_range_extent1, segment_range_min1);
+				// Fixed width tracks have a known size, only variable tracks need their bit rates to be read
+				uint32_t num_variable_tracks = 0;
+				uint32_t fixed_tracks_size = 0;
 
-								context.segment_range_data_offset += context.num_rotation_components * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
-							}
+				if (is_rotation_format_variable(rotation_format))
+					num_variable_tracks += num_animated_rotations;
+				else
+					fixed_tracks_size += num_animated_rotations * get_packed_rotation_size(rotation_format);
 
-							if (are_clip_rotations_normalized)
-							{
-								Vector4_32 clip_range_min = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset);
-								Vector4_32 clip_range_extent = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset + (context.num_rotation_components * sizeof(float)));
+				if (is_vector_format_variable(translation_format))
+					num_variable_tracks += num_animated_translations;
+				else
+					fixed_tracks_size += num_animated_translations * get_packed_vector_size(translation_format);
 
-								rotation0_xyz = vector_mul_add(rotation0_xyz, clip_range_extent, clip_range_min);
-								rotation1_xyz = vector_mul_add(rotation1_xyz, clip_range_extent, clip_range_min);
+				out_offsets.bone_index = bone_index;
+				out_offsets.num_preceding_variable_tracks = safe_static_cast<uint16_t>(num_variable_tracks);
+				out_offsets.preceding_fixed_tracks_size = fixed_tracks_size;
+			}
 
-								context.clip_range_data_offset += context.num_rotation_components * sizeof(float) * 2;
-							}
+			// Records where the data of each masked bone starts, the bone indices must be sorted and unique
+			template<class SettingsType>
+			inline void build_bone_mask(const SettingsType& settings, const ClipHeader& header, const uint16_t* bone_indices, uint16_t num_bone_indices, BoneMask& bone_mask)
+			{
+				for (uint16_t entry_index = 0; entry_index < num_bone_indices; ++entry_index)
+				{
+					const uint16_t bone_index = bone_indices[entry_index];
+					ACL_ENSURE(bone_index < header.num_bones && (entry_index == 0 || bone_indices[entry_index - 1] < bone_index), "Bone indices must be sorted, unique, and smaller than the number of bones");
 
-							rotation0 = quat_from_positive_w(rotation0_xyz);
-							rotation1 = quat_from_positive_w(rotation1_xyz);
+					calculate_bone_offsets(settings, header, bone_index, bone_mask.entries[entry_index]);
+				}
 
-							const uint32_t rotation_size = get_packed_rotation_size(rotation_format);
-							context.key_frame_byte_offset0 += rotation_size;
-							context.key_frame_byte_offset1 += rotation_size;
+				bone_mask.constant_tracks_bitset = header.get_constant_tracks_bitset();
+				bone_mask.num_entries = num_bone_indices;
+			}
 
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
-								context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
-							}
-						}
-						else if (rotation_format == RotationFormat8::QuatDropW_32 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_32))
-						{
-							Vector4_32 rotation0_xyz = unpack_vector3_32(11, 11, 10, are_clip_rotations_normalized, context.animated_track_data0 + context.key_frame_byte_offset0);
-							Vector4_32 rotation1_xyz = unpack_vector3_32(11, 11, 10, are_clip_rotations_normalized, context.animated_track_data1 + context.key_frame_byte_offset1);
+			// Advances the context offsets to the first track of the provided bone.
+			// Must be called right after seeking, the offsets are calculated from the start of the pose.
+			template<class SettingsType>
+			inline void skip_to_bone(const SettingsType& settings, const ClipHeader& header, uint32_t bone_index, DecompressionContext& context)
+			{
+				BoneMaskEntry bone_offsets;
+				calculate_bone_offsets(settings, header, safe_static_cast<uint16_t>(bone_index), bone_offsets);
 
-							if (are_segment_rotations_normalized)
-							{
-#if ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BIT_SIZE == 8
-								Vector4_32 segment_range_min0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-								Vector4_32 segment_range_min1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-#else
-								Vector4_32 segment_range_min0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-								Vector4_32 segment_range_min1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-#endif
+				context.constant_track_data_offset += bone_offsets.constant_track_data_offset;
+				context.clip_range_data_offset += bone_offsets.clip_range_data_offset;
+				context.segment_range_data_offset += bone_offsets.segment_range_data_offset;
 
-								rotation0_xyz = vector_mul_add(rotation0_xyz, segment_range_extent0, segment_range_min0);
-								rotation1_xyz = vector_mul_add(rotation1_xyz, segment_range_extent1, segment_range_min1);
+				const uint32_t num_variable_tracks = bone_offsets.num_preceding_variable_tracks;
+				const uint32_t fixed_tracks_size = bone_offsets.preceding_fixed_tracks_size;
 
-								context.segment_range_data_offset += context.num_rotation_components * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
-							}
+				uint32_t variable_tracks_num_bits0 = 0;
+				uint32_t variable_tracks_num_bits1 = 0;
+				for (uint32_t variable_track_index = 0; variable_track_index < num_variable_tracks; ++variable_track_index)
+				{
+					uint8_t num_bits_at_bit_rate0 = get_num_bits_at_bit_rate(context.format_per_track_data0[variable_track_index]) * 3;	// 3 components
+					uint8_t num_bits_at_bit_rate1 = get_num_bits_at_bit_rate(context.format_per_track_data1[variable_track_index]) * 3;	// 3 components
 
-							if (are_clip_rotations_normalized)
-							{
-								Vector4_32 clip_range_min = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset);
-								Vector4_32 clip_range_extent = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset + (context.num_rotation_components * sizeof(float)));
+					if (settings.supports_mixed_packing() && context.clip_context->has_mixed_packing)
+					{
+						num_bits_at_bit_rate0 = align_to(num_bits_at_bit_rate0, MIXED_PACKING_ALIGNMENT_NUM_BITS);
+						num_bits_at_bit_rate1 = align_to(num_bits_at_bit_rate1, MIXED_PACKING_ALIGNMENT_NUM_BITS);
+					}
 
-								rotation0_xyz = vector_mul_add(rotation0_xyz, clip_range_extent, clip_range_min);
-								rotation1_xyz = vector_mul_add(rotation1_xyz, clip_range_extent, clip_range_min);
+					variable_tracks_num_bits0 += num_bits_at_bit_rate0;
+					variable_tracks_num_bits1 += num_bits_at_bit_rate1;
+				}
 
-								context.clip_range_data_offset += context.num_rotation_components * sizeof(float) * 2;
-							}
+				context.format_per_track_data_offset = num_variable_tracks;
 
-							rotation0 = quat_from_positive_w(rotation0_xyz);
-							rotation1 = quat_from_positive_w(rotation1_xyz);
+				if (settings.supports_mixed_packing() && context.clip_context->has_mixed_packing)
+				{
+					context.key_frame_bit_offset0 += variable_tracks_num_bits0 + (fixed_tracks_size * 8);
+					context.key_frame_bit_offset1 += variable_tracks_num_bits1 + (fixed_tracks_size * 8);
+					context.key_frame_byte_offset0 = context.key_frame_bit_offset0 / 8;
+					context.key_frame_byte_offset1 = context.key_frame_bit_offset1 / 8;
+				}
+				else
+				{
+					context.key_frame_bit_offset0 += variable_tracks_num_bits0;
+					context.key_frame_bit_offset1 += variable_tracks_num_bits1;
+					context.key_frame_byte_offset0 += fixed_tracks_size;
+					context.key_frame_byte_offset1 += fixed_tracks_size;
+				}
 
-							const uint32_t rotation_size = get_packed_rotation_size(rotation_format);
-							context.key_frame_byte_offset0 += rotation_size;
-							context.key_frame_byte_offset1 += rotation_size;
+				context.default_track_offset = bone_index * Constants::NUM_TRACKS_PER_BONE;
+				context.constant_track_offset = context.default_track_offset;
+			}
 
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
-								context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
-							}
-						}
-						else if (rotation_format == RotationFormat8::QuatDropW_Variable && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_Variable))
-						{
-							uint8_t bit_rate0 = context.format_per_track_data0[context.format_per_track_data_offset];
-							uint8_t bit_rate1 = context.format_per_track_data1[context.format_per_track_data_offset++];
-							uint8_t num_bits_at_bit_rate0 = get_num_bits_at_bit_rate(bit_rate0);
-							uint8_t num_bits_at_bit_rate1 = get_num_bits_at_bit_rate(bit_rate1);
-
-							Vector4_32 rotation0_xyz;
-							Vector4_32 rotation1_xyz;
-
-							if (is_pack_0_bit_rate(bit_rate0))
-								(void)bit_rate0;
-							else if (is_pack_72_bit_rate(bit_rate0))
-								rotation0_xyz = unpack_vector3_72(are_clip_rotations_normalized, context.animated_track_data0, context.key_frame_bit_offset0);
-							else if (is_pack_96_bit_rate(bit_rate0))
-								rotation0_xyz = unpack_vector3_96(context.animated_track_data0, context.key_frame_bit_offset0);
-							else
-								rotation0_xyz = unpack_vector3_n(num_bits_at_bit_rate0, num_bits_at_bit_rate0, num_bits_at_bit_rate0, are_clip_rotations_normalized, context.animated_track_data0, context.key_frame_bit_offset0);
-
-							if (is_pack_0_bit_rate(bit_rate1))
-								(void)bit_rate1;
-							else if (is_pack_72_bit_rate(bit_rate1))
-								rotation1_xyz = unpack_vector3_72(are_clip_rotations_normalized, context.animated_track_data1, context.key_frame_bit_offset1);
-							else if (is_pack_96_bit_rate(bit_rate1))
-								rotation1_xyz = unpack_vector3_96(context.animated_track_data1, context.key_frame_bit_offset1);
-							else
-								rotation1_xyz = unpack_vector3_n(num_bits_at_bit_rate1, num_bits_at_bit_rate1, num_bits_at_bit_rate1, are_clip_rotations_normalized, context.animated_track_data1, context.key_frame_bit_offset1);
+			// Skipping a track only advances the context offsets past its data without unpacking it
+			template<class SettingsType>
+			inline void skip_constant_rotation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				const RotationFormat8 rotation_format = settings.get_rotation_format(header.rotation_format);
+				const RotationFormat8 packed_format = is_rotation_format_variable(rotation_format) ? get_highest_variant_precision(get_rotation_variant(rotation_format)) : rotation_format;
 
-							if (are_segment_rotations_normalized)
-							{
-#if ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BIT_SIZE == 8
-								if (is_pack_0_bit_rate(bit_rate0))
-									rotation0_xyz = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset, true);
-								else
-								{
-									Vector4_32 segment_range_min0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset, true);
-									Vector4_32 segment_range_extent0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-
-									rotation0_xyz = vector_mul_add(rotation0_xyz, segment_range_extent0, segment_range_min0);
-								}
-
-								if (is_pack_0_bit_rate(bit_rate1))
-									rotation1_xyz = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset, true);
-								else
-								{
-									Vector4_32 segment_range_min1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset, true);
-									Vector4_32 segment_range_extent1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint8_t)), true);
-
-									rotation1_xyz = vector_mul_add(rotation1_xyz, segment_range_extent1, segment_range_min1);
-								}
-#else
-								if (is_pack_0_bit_rate(bit_rate0))
-									rotation0_xyz = unpack_vector3_96(context.segment_range_data0 + context.segment_range_data_offset);
-								else
-								{
-									Vector4_32 segment_range_min0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset, true);
-									Vector4_32 segment_range_extent0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-
-									rotation0_xyz = vector_mul_add(rotation0_xyz, segment_range_extent0, segment_range_min0);
-								}
-
-								if (is_pack_0_bit_rate(bit_rate1))
-									rotation1_xyz = unpack_vector3_96(context.segment_range_data1 + context.segment_range_data_offset);
-								else
-								{
-									Vector4_32 segment_range_min1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset, true);
-									Vector4_32 segment_range_extent1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset + (context.num_rotation_components * sizeof(uint16_t)), true);
-
-									rotation1_xyz = vector_mul_add(rotation1_xyz, segment_range_extent1, segment_range_min1);
-								}
-#endif
+				context.constant_track_data_offset += get_packed_rotation_size(packed_format);
+			}
 
-								context.segment_range_data_offset += context.num_rotation_components * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
-							}
+			template<class SettingsType>
+			inline void skip_animated_track_key_frames(const SettingsType& settings, DecompressionContext& context, bool is_variable, uint32_t packed_size)
+			{
+				if (is_variable)
+				{
+					uint8_t num_bits_read0 = get_num_bits_at_bit_rate(context.format_per_track_data0[context.format_per_track_data_offset]) * 3;	// 3 components
+					uint8_t num_bits_read1 = get_num_bits_at_bit_rate(context.format_per_track_data1[context.format_per_track_data_offset++]) * 3;	// 3 components
 
-							if (are_clip_rotations_normalized)
-							{
-								Vector4_32 clip_range_min = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset);
-								Vector4_32 clip_range_extent = vector_unaligned_load(context.clip_range_data + context.clip_range_data_offset + (context.num_rotation_components * sizeof(float)));
+					if (settings.supports_mixed_packing() && context.clip_context->has_mixed_packing)
+					{
+						num_bits_read0 = align_to(num_bits_read0, MIXED_PACKING_ALIGNMENT_NUM_BITS);
+						num_bits_read1 = align_to(num_bits_read1, MIXED_PACKING_ALIGNMENT_NUM_BITS);
+					}
 
-								rotation0_xyz = vector_mul_add(rotation0_xyz, clip_range_extent, clip_range_min);
-								rotation1_xyz = vector_mul_add(rotation1_xyz, clip_range_extent, clip_range_min);
+					context.key_frame_bit_offset0 += num_bits_read0;
+					context.key_frame_bit_offset1 += num_bits_read1;
 
-								context.clip_range_data_offset += context.num_rotation_components * sizeof(float) * 2;
-							}
+					if (settings.supports_mixed_packing() && context.clip_context->has_mixed_packing)
+					{
+						context.key_frame_byte_offset0 = context.key_frame_bit_offset0 / 8;
+						context.key_frame_byte_offset1 = context.key_frame_bit_offset1 / 8;
+					}
+				}
+				else
+				{
+					context.key_frame_byte_offset0 += packed_size;
+					context.key_frame_byte_offset1 += packed_size;
 
-							rotation0 = quat_from_positive_w(rotation0_xyz);
-							rotation1 = quat_from_positive_w(rotation1_xyz);
+					if (settings.supports_mixed_packing() && context.clip_context->has_mixed_packing)
+					{
+						context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
+						context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
+					}
+				}
+			}
 
-							uint8_t num_bits_read0 = num_bits_at_bit_rate0 * 3;
-							uint8_t num_bits_read1 = num_bits_at_bit_rate1 * 3;
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								num_bits_read0 = align_to(num_bits_read0, MIXED_PACKING_ALIGNMENT_NUM_BITS);
-								num_bits_read1 = align_to(num_bits_read1, MIXED_PACKING_ALIGNMENT_NUM_BITS);
-							}
+			template<class SettingsType>
+			inline void skip_animated_rotation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				const RotationFormat8 rotation_format = settings.get_rotation_format(header.rotation_format);
+				const RangeReductionFlags8 clip_range_reduction = settings.get_clip_range_reduction(header.clip_range_reduction);
+				const RangeReductionFlags8 segment_range_reduction = settings.get_segment_range_reduction(header.segment_range_reduction);
 
-							context.key_frame_bit_offset0 += num_bits_read0;
-							context.key_frame_bit_offset1 += num_bits_read1;
+				if (is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Rotations))
+					context.segment_range_data_offset += context.clip_context->num_rotation_components * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
 
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_byte_offset0 = context.key_frame_bit_offset0 / 8;
-								context.key_frame_byte_offset1 = context.key_frame_bit_offset1 / 8;
-							}
-						}
+				if (is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Rotations))
+					context.clip_range_data_offset += context.clip_context->num_rotation_components * sizeof(float) * 2;
 
-						rotation = quat_lerp(rotation0, rotation1, context.interpolation_alpha);
+				const bool is_variable = is_rotation_format_variable(rotation_format);
+				skip_animated_track_key_frames(settings, context, is_variable, is_variable ? 0 : get_packed_rotation_size(rotation_format));
+			}
 
-						ACL_ENSURE(quat_is_finite(rotation), "Rotation is not valid!");
-						ACL_ENSURE(quat_is_normalized(rotation), "Rotation is not normalized!");
-					}
+			template<class SettingsType>
+			inline void skip_rotation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				bool is_rotation_default = bitset_test(context.clip_context->default_tracks_bitset, context.clip_context->bitset_size, context.default_track_offset);
+				if (!is_rotation_default)
+				{
+					bool is_rotation_constant = bitset_test(context.clip_context->constant_tracks_bitset, context.clip_context->bitset_size, context.constant_track_offset);
+					if (is_rotation_constant)
+						skip_constant_rotation(settings, header, context);
+					else
+						skip_animated_rotation(settings, header, context);
 				}
 
 				context.default_track_offset++;
 				context.constant_track_offset++;
-				return rotation;
 			}
 
 			template<class SettingsType>
-			inline Vector4_32 decompress_translation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			inline void skip_constant_translation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
 			{
-				Vector4_32 translation;
+				context.constant_track_data_offset += get_packed_vector_size(VectorFormat8::Vector3_96);
+			}
 
-				bool is_translation_default = bitset_test(context.default_tracks_bitset, context.bitset_size, context.default_track_offset);
-				if (is_translation_default)
-				{
-					translation = vector_zero_32();
-				}
-				else
-				{
-					bool is_translation_constant = bitset_test(context.constant_tracks_bitset, context.bitset_size, context.constant_track_offset);
-					if (is_translation_constant)
-					{
-						// Constant translation tracks store the remaining sample with full precision
-						translation = unpack_vector3_96(context.constant_track_data + context.constant_track_data_offset);
+			template<class SettingsType>
+			inline void skip_animated_translation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				const VectorFormat8 translation_format = settings.get_translation_format(header.translation_format);
+				const RangeReductionFlags8 clip_range_reduction = settings.get_clip_range_reduction(header.clip_range_reduction);
+				const RangeReductionFlags8 segment_range_reduction = settings.get_segment_range_reduction(header.segment_range_reduction);
 
-						ACL_ENSURE(vector_is_finite3(translation), "Translation is not valid!");
+				if (is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Translations))
+					context.segment_range_data_offset += 3 * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
 
-						context.constant_track_data_offset += get_packed_vector_size(VectorFormat8::Vector3_96);
-					}
+				if (is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Translations))
+					context.clip_range_data_offset += 3 * sizeof(float) * 2;
+
+				const bool is_variable = is_vector_format_variable(translation_format);
+				skip_animated_track_key_frames(settings, context, is_variable, is_variable ? 0 : get_packed_vector_size(translation_format));
+			}
+
+			template<class SettingsType>
+			inline void skip_translation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				bool is_translation_default = bitset_test(context.clip_context->default_tracks_bitset, context.clip_context->bitset_size, context.default_track_offset);
+				if (!is_translation_default)
+				{
+					bool is_translation_constant = bitset_test(context.clip_context->constant_tracks_bitset, context.clip_context->bitset_size, context.constant_track_offset);
+					if (is_translation_constant)
+						skip_constant_translation(settings, header, context);
+					else
+						skip_animated_translation(settings, header, context);
+				}
+
+				context.default_track_offset++;
+				context.constant_track_offset++;
+			}
+
+			template<class SettingsType>
+			inline Quat_32 unpack_constant_rotation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				const RotationFormat8 rotation_format = settings.get_rotation_format(header.rotation_format);
+
+				Quat_32 rotation;
+
+				const RotationFormat8 packed_format = is_rotation_format_variable(rotation_format) ? get_highest_variant_precision(get_rotation_variant(rotation_format)) : rotation_format;
+
+				if (packed_format == RotationFormat8::Quat_128 && settings.is_rotation_format_supported(RotationFormat8::Quat_128))
+					rotation = unpack_quat_128(context.clip_context->constant_track_data + context.constant_track_data_offset);
+				else if (packed_format == RotationFormat8::QuatDropW_96 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_96))
+					rotation = unpack_quat_96(context.clip_context->constant_track_data + context.constant_track_data_offset);
+				else if (packed_format == RotationFormat8::QuatDropW_48 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_48))
+					rotation = unpack_quat_48(context.clip_context->constant_track_data + context.constant_track_data_offset);
+				else if (packed_format == RotationFormat8::QuatDropW_32 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_32))
+					rotation = unpack_quat_32(context.clip_context->constant_track_data + context.constant_track_data_offset);
+
+				ACL_ENSURE(quat_is_finite(rotation), "Rotation is not valid!");
+				ACL_ENSURE(quat_is_normalized(rotation), "Rotation is not normalized!");
+
+				context.constant_track_data_offset += get_packed_rotation_size(packed_format);
+
+				return rotation;
+			}
+
+			// Unpacks a single key frame of an animated rotation from the provided segment data, at the provided offsets.
+			// The context offsets aren't advanced, skipping the track afterwards moves past the data of both key frames.
+			template<class SettingsType>
+			inline Quat_32 decompress_animated_rotation_key(const SettingsType& settings, const ClipHeader& header, const DecompressionContext& context,
+				const uint8_t* format_per_track_data, const uint8_t* segment_range_data, const uint8_t* animated_track_data,
+				uint32_t key_frame_byte_offset, uint32_t key_frame_bit_offset)
+			{
+				const RotationFormat8 rotation_format = settings.get_rotation_format(header.rotation_format);
+
+				const RangeReductionFlags8 clip_range_reduction = settings.get_clip_range_reduction(header.clip_range_reduction);
+				const RangeReductionFlags8 segment_range_reduction = settings.get_segment_range_reduction(header.segment_range_reduction);
+				const bool are_clip_rotations_normalized = is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Rotations);
+				const bool are_segment_rotations_normalized = is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Rotations);
+
+				if (rotation_format == RotationFormat8::Quat_128 && settings.is_rotation_format_supported(RotationFormat8::Quat_128))
+				{
+					Vector4_32 rotation_xyzw = unpack_vector4_128(animated_track_data + key_frame_byte_offset);
+
+					if (are_segment_rotations_normalized)
+					{
+#if ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BIT_SIZE == 8
+						Vector4_32 segment_range_min = unpack_vector4_32(segment_range_data + context.segment_range_data_offset, true);
+						Vector4_32 segment_range_extent = unpack_vector4_32(segment_range_data + context.segment_range_data_offset + (context.clip_context->num_rotation_components * sizeof(uint8_t)), true);
+#else
+						Vector4_32 segment_range_min = unpack_vector4_64(segment_range_data + context.segment_range_data_offset, true);
+						Vector4_32 segment_range_extent = unpack_vector4_64(segment_range_data + context.segment_range_data_offset + (context.clip_context->num_rotation_components * sizeof(uint16_t)), true);
+#endif
+
+						rotation_xyzw = vector_mul_add(rotation_xyzw, segment_range_extent, segment_range_min);
+					}
+
+					if (are_clip_rotations_normalized)
+					{
+						Vector4_32 clip_range_min = vector_unaligned_load(context.clip_context->clip_range_data + context.clip_range_data_offset);
+						Vector4_32 clip_range_extent = vector_unaligned_load(context.clip_context->clip_range_data + context.clip_range_data_offset + (context.clip_context->num_rotation_components * sizeof(float)));
+
+						rotation_xyzw = vector_mul_add(rotation_xyzw, clip_range_extent, clip_range_min);
+					}
+
+					return vector_to_quat(rotation_xyzw);
+				}
+
+				Vector4_32 rotation_xyz;
+				uint8_t bit_rate;
+				bool is_constant_bit_rate = false;
+
+				if (rotation_format == RotationFormat8::QuatDropW_96 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_96))
+					rotation_xyz = unpack_vector3_96(animated_track_data + key_frame_byte_offset);
+				else if (rotation_format == RotationFormat8::QuatDropW_48 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_48))
+					rotation_xyz = unpack_vector3_48(animated_track_data + key_frame_byte_offset, are_clip_rotations_normalized);
+				else if (rotation_format == RotationFormat8::QuatDropW_32 && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_32))
+					rotation_xyz = unpack_vector3_32(11, 11, 10, are_clip_rotations_normalized, animated_track_data + key_frame_byte_offset);
+				else if (rotation_format == RotationFormat8::QuatDropW_Variable && settings.is_rotation_format_supported(RotationFormat8::QuatDropW_Variable))
+				{
+					bit_rate = format_per_track_data[context.format_per_track_data_offset];
+					uint8_t num_bits_at_bit_rate = get_num_bits_at_bit_rate(bit_rate);
+
+					// Constant bit rates store their value in the segment range data
+					if (is_pack_0_bit_rate(bit_rate))
+						is_constant_bit_rate = true;
+					else if (is_pack_72_bit_rate(bit_rate))
+						rotation_xyz = unpack_vector3_72(are_clip_rotations_normalized, animated_track_data, key_frame_bit_offset);
+					else if (is_pack_96_bit_rate(bit_rate))
+						rotation_xyz = unpack_vector3_96(animated_track_data, key_frame_bit_offset);
+					else
+						rotation_xyz = unpack_vector3_n(num_bits_at_bit_rate, num_bits_at_bit_rate, num_bits_at_bit_rate, are_clip_rotations_normalized, animated_track_data, key_frame_bit_offset);
+				}
+
+				if (are_segment_rotations_normalized)
+				{
+#if ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BIT_SIZE == 8
+					if (is_constant_bit_rate)
+						rotation_xyz = unpack_vector3_48(segment_range_data + context.segment_range_data_offset, true);
+					else
+					{
+						Vector4_32 segment_range_min = unpack_vector3_24(segment_range_data + context.segment_range_data_offset, true);
+						Vector4_32 segment_range_extent = unpack_vector3_24(segment_range_data + context.segment_range_data_offset + (context.clip_context->num_rotation_components * sizeof(uint8_t)), true);
+
+						rotation_xyz = vector_mul_add(rotation_xyz, segment_range_extent, segment_range_min);
+					}
+#else
+					if (is_constant_bit_rate)
+						rotation_xyz = unpack_vector3_96(segment_range_data + context.segment_range_data_offset);
+					else
+					{
+						Vector4_32 segment_range_min = unpack_vector3_48(segment_range_data + context.segment_range_data_offset, true);
+						Vector4_32 segment_range_extent = unpack_vector3_48(segment_range_data + context.segment_range_data_offset + (context.clip_context->num_rotation_components * sizeof(uint16_t)), true);
+
+						rotation_xyz = vector_mul_add(rotation_xyz, segment_range_extent, segment_range_min);
+					}
+#endif
+				}
+
+				if (are_clip_rotations_normalized)
+				{
+					Vector4_32 clip_range_min = vector_unaligned_load(context.clip_context->clip_range_data + context.clip_range_data_offset);
+					Vector4_32 clip_range_extent = vector_unaligned_load(context.clip_context->clip_range_data + context.clip_range_data_offset + (context.clip_context->num_rotation_components * sizeof(float)));
+
+					rotation_xyz = vector_mul_add(rotation_xyz, clip_range_extent, clip_range_min);
+				}
+
+				return quat_from_positive_w(rotation_xyz);
+			}
+
+			template<class SettingsType>
+			inline void decompress_animated_rotation_keys(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context, Quat_32& out_rotation0, Quat_32& out_rotation1)
+			{
+				out_rotation0 = decompress_animated_rotation_key(settings, header, context, context.format_per_track_data0, context.segment_range_data0, context.animated_track_data0, context.key_frame_byte_offset0, context.key_frame_bit_offset0);
+				out_rotation1 = decompress_animated_rotation_key(settings, header, context, context.format_per_track_data1, context.segment_range_data1, context.animated_track_data1, context.key_frame_byte_offset1, context.key_frame_bit_offset1);
+
+				skip_animated_rotation(settings, header, context);
+			}
+
+			template<class SettingsType>
+			inline Quat_32 decompress_animated_rotation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				Quat_32 rotation;
+				if (settings.get_sampling_mode() == SamplingMode8::Linear)
+				{
+					Quat_32 rotation0;
+					Quat_32 rotation1;
+					decompress_animated_rotation_keys(settings, header, context, rotation0, rotation1);
+
+					rotation = quat_lerp(rotation0, rotation1, context.interpolation_alpha);
+				}
+				else
+				{
+					// Seeking selected a single key frame, both key frames are the same
+					rotation = quat_normalize(decompress_animated_rotation_key(settings, header, context, context.format_per_track_data0, context.segment_range_data0, context.animated_track_data0, context.key_frame_byte_offset0, context.key_frame_bit_offset0));
+
+					skip_animated_rotation(settings, header, context);
+				}
+
+				ACL_ENSURE(quat_is_finite(rotation), "Rotation is not valid!");
+				ACL_ENSURE(quat_is_normalized(rotation), "Rotation is not normalized!");
+
+				return rotation;
+			}
+
+			template<class SettingsType>
+			inline Quat_32 decompress_rotation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				Quat_32 rotation;
+
+				bool is_rotation_default = bitset_test(context.clip_context->default_tracks_bitset, context.clip_context->bitset_size, context.default_track_offset);
+				if (is_rotation_default)
+				{
+					rotation = quat_identity_32();
+				}
+				else
+				{
+					bool is_rotation_constant = bitset_test(context.clip_context->constant_tracks_bitset, context.clip_context->bitset_size, context.constant_track_offset);
+					if (is_rotation_constant)
+						rotation = decompress_constant_rotation(settings, header, context, context.default_track_offset / Constants::NUM_TRACKS_PER_BONE);
+					else
+						rotation = decompress_animated_rotation(settings, header, context);
+				}
+
+				context.default_track_offset++;
+				context.constant_track_offset++;
+				return rotation;
+			}
+
+			template<class SettingsType>
+			inline Vector4_32 unpack_constant_translation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				// Constant translation tracks store the remaining sample with full precision
+				Vector4_32 translation = unpack_vector3_96(context.clip_context->constant_track_data + context.constant_track_data_offset);
+
+				ACL_ENSURE(vector_is_finite3(translation), "Translation is not valid!");
+
+				context.constant_track_data_offset += get_packed_vector_size(VectorFormat8::Vector3_96);
+
+				return translation;
+			}
+
+			template<class SettingsType>
+			inline Quat_32 decompress_constant_rotation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context, uint32_t bone_index)
+			{
+				if (!settings.use_constant_track_cache())
+					return unpack_constant_rotation(settings, header, context);
+
+				// Cached values were validated when the cache was built
+				skip_constant_rotation(settings, header, context);
+				return context.clip_context->constant_rotations[bone_index];
+			}
+
+			template<class SettingsType>
+			inline Vector4_32 decompress_constant_translation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context, uint32_t bone_index)
+			{
+				if (!settings.use_constant_track_cache())
+					return unpack_constant_translation(settings, header, context);
+
+				skip_constant_translation(settings, header, context);
+				return context.clip_context->constant_translations[bone_index];
+			}
+
+			// The constant track cache holds every constant track unpacked once per clip, indexed by bone.
+			// Rotations and translations live in separate arrays, decompressing a constant track is then a copy.
+			// Bones without a constant track are left as identity.
+			template<class SettingsType>
+			inline void build_constant_track_cache(Allocator& allocator, const SettingsType& settings, const ClipHeader& header, ClipDecompressionContext& clip_context)
+			{
+				const uint32_t num_bones = header.num_bones;
+
+				Quat_32* constant_rotations = allocate_type_array<Quat_32>(allocator, num_bones);
+				Vector4_32* constant_translations = allocate_type_array<Vector4_32>(allocator, num_bones);
+
+				DecompressionContext context;
+				initialize_context(clip_context, context);
+
+				for (uint32_t bone_index = 0; bone_index < num_bones; ++bone_index)
+				{
+					const uint32_t rotation_track_index = bone_index * Constants::NUM_TRACKS_PER_BONE;
+					if (!bitset_test(clip_context.default_tracks_bitset, clip_context.bitset_size, rotation_track_index) && bitset_test(clip_context.constant_tracks_bitset, clip_context.bitset_size, rotation_track_index))
+						constant_rotations[bone_index] = unpack_constant_rotation(settings, header, context);
+					else
+						constant_rotations[bone_index] = quat_identity_32();
+
+					const uint32_t translation_track_index = rotation_track_index + 1;
+					if (!bitset_test(clip_context.default_tracks_bitset, clip_context.bitset_size, translation_track_index) && bitset_test(clip_context.constant_tracks_bitset, clip_context.bitset_size, translation_track_index))
+						constant_translations[bone_index] = unpack_constant_translation(settings, header, context);
+					else
+						constant_translations[bone_index] = vector_zero_32();
+				}
+
+				clip_context.constant_rotations = constant_rotations;
+				clip_context.constant_translations = constant_translations;
+				clip_context.num_constant_cached_bones = safe_static_cast<uint16_t>(num_bones);
+			}
+
+			// Unpacks a single key frame of an animated translation from the provided segment data, at the provided offsets.
+			// The context offsets aren't advanced, skipping the track afterwards moves past the data of both key frames.
+			template<class SettingsType>
+			inline Vector4_32 decompress_animated_translation_key(const SettingsType& settings, const ClipHeader& header, const DecompressionContext& context,
+				const uint8_t* format_per_track_data, const uint8_t* segment_range_data, const uint8_t* animated_track_data,
+				uint32_t key_frame_byte_offset, uint32_t key_frame_bit_offset)
+			{
+				const VectorFormat8 translation_format = settings.get_translation_format(header.translation_format);
+				const RangeReductionFlags8 clip_range_reduction = settings.get_clip_range_reduction(header.clip_range_reduction);
+				const RangeReductionFlags8 segment_range_reduction = settings.get_segment_range_reduction(header.segment_range_reduction);
+
+				Vector4_32 translation;
+				uint8_t bit_rate;
+				bool is_constant_bit_rate = false;
+
+				if (translation_format == VectorFormat8::Vector3_96 && settings.is_translation_format_supported(VectorFormat8::Vector3_96))
+					translation = unpack_vector3_96(animated_track_data + key_frame_byte_offset);
+				else if (translation_format == VectorFormat8::Vector3_48 && settings.is_translation_format_supported(VectorFormat8::Vector3_48))
+					translation = unpack_vector3_48(animated_track_data + key_frame_byte_offset, true);
+				else if (translation_format == VectorFormat8::Vector3_32 && settings.is_translation_format_supported(VectorFormat8::Vector3_32))
+					translation = unpack_vector3_32(11, 11, 10, true, animated_track_data + key_frame_byte_offset);
+				else if (translation_format == VectorFormat8::Vector3_Variable && settings.is_translation_format_supported(VectorFormat8::Vector3_Variable))
+				{
+					bit_rate = format_per_track_data[context.format_per_track_data_offset];
+					uint8_t num_bits_at_bit_rate = get_num_bits_at_bit_rate(bit_rate);
+
+					// Constant bit rates store their value in the segment range data
+					if (is_pack_0_bit_rate(bit_rate))
+						is_constant_bit_rate = true;
+					else if (is_pack_72_bit_rate(bit_rate))
+						translation = unpack_vector3_72(true, animated_track_data, key_frame_bit_offset);
+					else if (is_pack_96_bit_rate(bit_rate))
+						translation = unpack_vector3_96(animated_track_data, key_frame_bit_offset);
+					else
+						translation = unpack_vector3_n(num_bits_at_bit_rate, num_bits_at_bit_rate, num_bits_at_bit_rate, true, animated_track_data, key_frame_bit_offset);
+				}
+
+				if (is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Translations))
+				{
+#if ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BIT_SIZE == 8
+					if (is_constant_bit_rate)
+						translation = unpack_vector3_48(segment_range_data + context.segment_range_data_offset, true);
+					else
+					{
+						Vector4_32 segment_range_min = unpack_vector3_24(segment_range_data + context.segment_range_data_offset, true);
+						Vector4_32 segment_range_extent = unpack_vector3_24(segment_range_data + context.segment_range_data_offset + (3 * sizeof(uint8_t)), true);
+
+						translation = vector_mul_add(translation, segment_range_extent, segment_range_min);
+					}
+#else
+					if (is_constant_bit_rate)
+						translation = unpack_vector3_96(segment_range_data + context.segment_range_data_offset);
+					else
+					{
+						Vector4_32 segment_range_min = unpack_vector3_48(segment_range_data + context.segment_range_data_offset, true);
+						Vector4_32 segment_range_extent = unpack_vector3_48(segment_range_data + context.segment_range_data_offset + (3 * sizeof(uint16_t)), true);
+
+						translation = vector_mul_add(translation, segment_range_extent, segment_range_min);
+					}
+#endif
+				}
+
+				if (is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Translations))
+				{
+					Vector4_32 clip_range_min = unpack_vector3_96(context.clip_context->clip_range_data + context.clip_range_data_offset);
+					Vector4_32 clip_range_extent = unpack_vector3_96(context.clip_context->clip_range_data + context.clip_range_data_offset + (3 * sizeof(float)));
+
+					translation = vector_mul_add(translation, clip_range_extent, clip_range_min);
+				}
+
+				return translation;
+			}
+
+			template<class SettingsType>
+			inline void decompress_animated_translation_keys(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context, Vector4_32& out_translation0, Vector4_32& out_translation1)
+			{
+				out_translation0 = decompress_animated_translation_key(settings, header, context, context.format_per_track_data0, context.segment_range_data0, context.animated_track_data0, context.key_frame_byte_offset0, context.key_frame_bit_offset0);
+				out_translation1 = decompress_animated_translation_key(settings, header, context, context.format_per_track_data1, context.segment_range_data1, context.animated_track_data1, context.key_frame_byte_offset1, context.key_frame_bit_offset1);
+
+				skip_animated_translation(settings, header, context);
+			}
+
+			template<class SettingsType>
+			inline Vector4_32 decompress_animated_translation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				Vector4_32 translation;
+				if (settings.get_sampling_mode() == SamplingMode8::Linear)
+				{
+					Vector4_32 translation0;
+					Vector4_32 translation1;
+					decompress_animated_translation_keys(settings, header, context, translation0, translation1);
+
+					translation = vector_lerp(translation0, translation1, context.interpolation_alpha);
+				}
+				else
+				{
+					// Seeking selected a single key frame, both key frames are the same
+					translation = decompress_animated_translation_key(settings, header, context, context.format_per_track_data0, context.segment_range_data0, context.animated_track_data0, context.key_frame_byte_offset0, context.key_frame_bit_offset0);
+
+					skip_animated_translation(settings, header, context);
+				}
+
+				ACL_ENSURE(vector_is_finite3(translation), "Translation is not valid!");
+
+				return translation;
+			}
+
+			template<class SettingsType>
+			inline Vector4_32 decompress_translation(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				Vector4_32 translation;
+
+				bool is_translation_default = bitset_test(context.clip_context->default_tracks_bitset, context.clip_context->bitset_size, context.default_track_offset);
+				if (is_translation_default)
+				{
+					translation = vector_zero_32();
+				}
+				else
+				{
+					bool is_translation_constant = bitset_test(context.clip_context->constant_tracks_bitset, context.clip_context->bitset_size, context.constant_track_offset);
+					if (is_translation_constant)
+						translation = decompress_constant_translation(settings, header, context, context.default_track_offset / Constants::NUM_TRACKS_PER_BONE);
 					else
+						translation = decompress_animated_translation(settings, header, context);
+				}
+
+				context.default_track_offset++;
+				context.constant_track_offset++;
+				return translation;
+			}
+
+			// Whether the writer doesn't need the value of an invariant track, either because writing it has no
+			// effect or because the output already holds it. Default tracks are also flagged as constant.
+			template<class OutputWriterType>
+			inline bool is_invariant_track_skipped(OutputWriterType& writer, const ClipDecompressionContext& clip_context, uint32_t track_index)
+			{
+				if (writer.skip_constant_bone_tracks() && bitset_test(clip_context.constant_tracks_bitset, clip_context.bitset_size, track_index))
+					return true;
+
+				return writer.skip_default_bone_tracks() && bitset_test(clip_context.default_tracks_bitset, clip_context.bitset_size, track_index);
+			}
+
+			// Decompresses the bones of a mask right after seeking, see decompress_partial_pose.
+			// Bones are written with their index in the mask instead of their bone index when requested.
+			template<class SettingsType, class OutputWriterType>
+			inline void decompress_bone_mask(const SettingsType& settings, const ClipHeader& header, const BoneMask& bone_mask, bool write_entry_indices, DecompressionContext& context, OutputWriterType& writer)
+			{
+				const bool has_mixed_packing = settings.supports_mixed_packing() && context.clip_context->has_mixed_packing;
+				const uint32_t pose_bit_offset0 = context.key_frame_bit_offset0;
+				const uint32_t pose_bit_offset1 = context.key_frame_bit_offset1;
+				const uint32_t pose_byte_offset0 = context.key_frame_byte_offset0;
+				const uint32_t pose_byte_offset1 = context.key_frame_byte_offset1;
+
+				uint32_t variable_track_index = 0;
+				uint32_t variable_tracks_num_bits0 = 0;
+				uint32_t variable_tracks_num_bits1 = 0;
+
+				for (uint32_t entry_index = 0; entry_index < bone_mask.num_entries; ++entry_index)
+				{
+					const BoneMaskEntry& entry = bone_mask.entries[entry_index];
+
+					for (; variable_track_index < entry.num_preceding_variable_tracks; ++variable_track_index)
+					{
+						uint32_t num_bits_at_bit_rate0 = get_num_bits_at_bit_rate(context.format_per_track_data0[variable_track_index]) * 3;	// 3 components
+						uint32_t num_bits_at_bit_rate1 = get_num_bits_at_bit_rate(context.format_per_track_data1[variable_track_index]) * 3;	// 3 components
+
+						if (has_mixed_packing)
+						{
+							num_bits_at_bit_rate0 = align_to(num_bits_at_bit_rate0, MIXED_PACKING_ALIGNMENT_NUM_BITS);
+							num_bits_at_bit_rate1 = align_to(num_bits_at_bit_rate1, MIXED_PACKING_ALIGNMENT_NUM_BITS);
+						}
+
+						variable_tracks_num_bits0 += num_bits_at_bit_rate0;
+						variable_tracks_num_bits1 += num_bits_at_bit_rate1;
+					}
+
+					context.default_track_offset = entry.bone_index * Constants::NUM_TRACKS_PER_BONE;
+					context.constant_track_offset = context.default_track_offset;
+					context.constant_track_data_offset = entry.constant_track_data_offset;
+					context.clip_range_data_offset = entry.clip_range_data_offset;
+					context.segment_range_data_offset = entry.segment_range_data_offset;
+					context.format_per_track_data_offset = entry.num_preceding_variable_tracks;
+
+					if (has_mixed_packing)
+					{
+						context.key_frame_bit_offset0 = pose_bit_offset0 + variable_tracks_num_bits0 + (entry.preceding_fixed_tracks_size * 8);
+						context.key_frame_bit_offset1 = pose_bit_offset1 + variable_tracks_num_bits1 + (entry.preceding_fixed_tracks_size * 8);
+						context.key_frame_byte_offset0 = context.key_frame_bit_offset0 / 8;
+						context.key_frame_byte_offset1 = context.key_frame_bit_offset1 / 8;
+					}
+					else
+					{
+						context.key_frame_bit_offset0 = pose_bit_offset0 + variable_tracks_num_bits0;
+						context.key_frame_bit_offset1 = pose_bit_offset1 + variable_tracks_num_bits1;
+						context.key_frame_byte_offset0 = pose_byte_offset0 + entry.preceding_fixed_tracks_size;
+						context.key_frame_byte_offset1 = pose_byte_offset1 + entry.preceding_fixed_tracks_size;
+					}
+
+					if (writer.skip_all_bone_rotations() || is_invariant_track_skipped(writer, *context.clip_context, context.default_track_offset))
+						skip_rotation(settings, header, context);
+					else
+					{
+						Quat_32 rotation = decompress_rotation(settings, header, context);
+						writer.write_bone_rotation(write_entry_indices ? entry_index : entry.bone_index, rotation);
+					}
+
+					// The next bone repositions every offset, skipping the translation isn't needed
+					if (!writer.skip_all_bone_translations() && !is_invariant_track_skipped(writer, *context.clip_context, context.default_track_offset))
+					{
+						Vector4_32 translation = decompress_translation(settings, header, context);
+						writer.write_bone_translation(write_entry_indices ? entry_index : entry.bone_index, translation);
+					}
+				}
+			}
+
+			// Enables the playback cursor on top of the provided settings, the context always tracks
+			// the key frames and segments of its last seek regardless of the settings it was used with
+			template<class SettingsType>
+			struct PlaybackCursorSettings : public SettingsType
+			{
+				explicit PlaybackCursorSettings(const SettingsType& settings) : SettingsType(settings) {}
+
+				constexpr bool use_playback_cursor() const { return true; }
+			};
+
+			// Decompresses the root transform at the provided sample time.
+			// The root is the first bone, its tracks are the first ones read after seeking.
+			template<class SettingsType>
+			inline Transform_32 decompress_root_transform(const SettingsType& settings, const ClipHeader& header, float sample_time, DecompressionContext& context)
+			{
+				seek(settings, header, sample_time, context);
+
+				const Quat_32 rotation = decompress_rotation(settings, header, context);
+				const Vector4_32 translation = decompress_translation(settings, header, context);
+				return transform_set(rotation, translation);
+			}
+
+			// Returns the delta that moves the root from its start transform to its end transform
+			inline Transform_32 calculate_root_motion_delta(const Transform_32& start_transform, const Transform_32& end_transform)
+			{
+				const Transform_32 delta = transform_mul(end_transform, transform_inverse(start_transform));
+				return transform_set(quat_normalize(delta.rotation), delta.translation);
+			}
+
+			// Number of sample times decompress_bones_at_times sorts together on the stack, longer lists are split
+			static constexpr uint32_t NUM_SORTED_SAMPLE_TIMES = 64;
+
+			// The key frame cache holds the decompressed values of both key frames surrounding the last sample time.
+			// Rotations and translations live in separate arrays, all the bones of the first key frame followed by
+			// those of the second key frame. Sampling again between the same key frames only interpolates.
+			// The cache is keyed on the clip key frame indices, moving to other key frames or segments refreshes it.
+			template<class SettingsType>
+			inline void update_key_frame_cache(const SettingsType& settings, const ClipHeader& header, DecompressionContext& context)
+			{
+				if (context.cached_key_frame0 == context.key_frame0 && context.cached_key_frame1 == context.key_frame1)
+					return;
+
+				const uint32_t num_bones = header.num_bones;
+				Quat_32* rotations0 = context.key_frame_cache_rotations;
+				Quat_32* rotations1 = rotations0 + num_bones;
+				Vector4_32* translations0 = context.key_frame_cache_translations;
+				Vector4_32* translations1 = translations0 + num_bones;
+
+				for (uint32_t bone_index = 0; bone_index < num_bones; ++bone_index)
+				{
+					const uint32_t rotation_track_index = bone_index * Constants::NUM_TRACKS_PER_BONE;
+					if (bitset_test(context.clip_context->default_tracks_bitset, context.clip_context->bitset_size, rotation_track_index))
+						rotations0[bone_index] = rotations1[bone_index] = quat_identity_32();
+					else if (bitset_test(context.clip_context->constant_tracks_bitset, context.clip_context->bitset_size, rotation_track_index))
+						rotations0[bone_index] = rotations1[bone_index] = decompress_constant_rotation(settings, header, context, bone_index);
+					else
+						decompress_animated_rotation_keys(settings, header, context, rotations0[bone_index], rotations1[bone_index]);
+
+					const uint32_t translation_track_index = rotation_track_index + 1;
+					if (bitset_test(context.clip_context->default_tracks_bitset, context.clip_context->bitset_size, translation_track_index))
+						translations0[bone_index] = translations1[bone_index] = vector_zero_32();
+					else if (bitset_test(context.clip_context->constant_tracks_bitset, context.clip_context->bitset_size, translation_track_index))
+						translations0[bone_index] = translations1[bone_index] = decompress_constant_translation(settings, header, context, bone_index);
+					else
+						decompress_animated_translation_keys(settings, header, context, translations0[bone_index], translations1[bone_index]);
+				}
+
+				context.cached_key_frame0 = context.key_frame0;
+				context.cached_key_frame1 = context.key_frame1;
+			}
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// Deriving from this struct and overriding these constexpr functions
+		// allow you to control which code is stripped for maximum performance.
+		// With these, you can:
+		//    - Support only a subset of the formats and statically strip the rest
+		//    - Force a single format and statically strip the rest
+		//    - Decide all of this at runtime by not making the overrides constexpr
+		//
+		// By default, all formats are supported.
+		//////////////////////////////////////////////////////////////////////////
+		struct DecompressionSettings
+		{
+			constexpr bool is_rotation_format_supported(RotationFormat8 format) const { return true; }
+			constexpr bool is_translation_format_supported(VectorFormat8 format) const { return true; }
+			constexpr RotationFormat8 get_rotation_format(RotationFormat8 format) const { return format; }
+			constexpr VectorFormat8 get_translation_format(VectorFormat8 format) const { return format; }
+
+			constexpr bool are_clip_range_reduction_flags_supported(RangeReductionFlags8 flags) const { return true; }
+			constexpr bool are_segment_range_reduction_flags_supported(RangeReductionFlags8 flags) const { return true; }
+			constexpr RangeReductionFlags8 get_clip_range_reduction(RangeReductionFlags8 flags) const { return flags; }
+			constexpr RangeReductionFlags8 get_segment_range_reduction(RangeReductionFlags8 flags) const { return flags; }
+
+			// Whether tracks must all be variable or all fixed width, or if they can be mixed and require padding
+			constexpr bool supports_mixed_packing() const { return true; }
+
+			// Whether the context precomputes a per-clip decode plan used by decompress_pose unless the writer requires bone order
+			// It costs 2 bytes per track in the context but skips the per track bitset tests
+			constexpr bool use_decode_plan() const { return false; }
+
+			// Whether seeking reuses the key frames and segments of the previous seek when they haven't changed
+			// Playback that advances by small increments mostly re-interpolates the same key frames
+			constexpr bool use_playback_cursor() const { return false; }
+
+			// Whether the context caches both decompressed key frames surrounding the last sample time in decompress_pose
+			// It costs 64 bytes per bone in the context but sampling between the same key frames only interpolates
+			constexpr bool use_key_frame_cache() const { return false; }
+
+			// Whether the context unpacks every constant track once instead of every time they are decompressed
+			// It costs 32 bytes per bone in the context but constant tracks are then copied without any unpacking
+			constexpr bool use_constant_track_cache() const { return false; }
+
+			// Whether seeking prefetches the key frames and the data decompression reads next
+			// It helps when the clip data is unlikely to be in the cache, e.g. with many clips or large crowds
+			constexpr bool use_software_prefetching() const { return false; }
+
+			// How poses are sampled between key frames. Sampling a single key frame skips the interpolation and
+			// only unpacks one key frame, for distant characters or to bake poses at the clip sample rate.
+			constexpr SamplingMode8 get_sampling_mode() const { return SamplingMode8::Linear; }
+		};
+
+		template<class SettingsType>
+		inline void* allocate_decompression_context(Allocator& allocator, const SettingsType& settings, const CompressedClip& clip)
+		{
+			using namespace impl;
+
+			OwningDecompressionContext* context = allocate_type<OwningDecompressionContext>(allocator);
+
+			ACL_ASSERT(is_aligned_to(&context->owned_clip_context, CONTEXT_ALIGN_AS), "Read-only decompression context is misaligned");
+
+			const ClipHeader& header = get_clip_header(clip);
+			initialize_clip_context(settings, header, context->owned_clip_context);
+			initialize_context(context->owned_clip_context, *context);
+
+			if (settings.use_decode_plan())
+				build_decode_plan(allocator, header, context->owned_clip_context);
+
+			if (settings.use_constant_track_cache())
+				build_constant_track_cache(allocator, settings, header, context->owned_clip_context);
+
+			if (settings.use_key_frame_cache())
+			{
+				context->key_frame_cache_rotations = allocate_type_array<Quat_32>(allocator, header.num_bones * 2);
+				context->key_frame_cache_translations = allocate_type_array<Vector4_32>(allocator, header.num_bones * 2);
+				context->num_cached_bones = header.num_bones;
+			}
+
+			return static_cast<DecompressionContext*>(context);
+		}
+
+		inline void deallocate_decompression_context(Allocator& allocator, void* opaque_context)
+		{
+			using namespace impl;
+
+			OwningDecompressionContext* context = static_cast<OwningDecompressionContext*>(safe_ptr_cast<DecompressionContext>(opaque_context));
+			ACL_ENSURE(context->clip_context == &context->owned_clip_context, "Only contexts allocated with allocate_decompression_context can be deallocated");
+
+			deallocate_type_array(allocator, const_cast<uint16_t*>(context->owned_clip_context.decode_plan), get_decode_plan_size(context->owned_clip_context));
+			deallocate_type_array(allocator, const_cast<Quat_32*>(context->owned_clip_context.constant_rotations), context->owned_clip_context.num_constant_cached_bones);
+			deallocate_type_array(allocator, const_cast<Vector4_32*>(context->owned_clip_context.constant_translations), context->owned_clip_context.num_constant_cached_bones);
+			deallocate_type_array(allocator, context->key_frame_cache_rotations, context->num_cached_bones * 2);
+			deallocate_type_array(allocator, context->key_frame_cache_translations, context->num_cached_bones * 2);
+			deallocate_type<OwningDecompressionContext>(allocator, context);
+		}
+
+		// Returns the number of bytes allocated for the decompression context, including its decode plan and caches if present
+		inline size_t get_decompression_context_size(const void* opaque_context)
+		{
+			using namespace impl;
+
+			const DecompressionContext* context = safe_ptr_cast<const DecompressionContext>(opaque_context);
+			return sizeof(OwningDecompressionContext)
+				+ (get_decode_plan_size(*context->clip_context) * sizeof(uint16_t))
+				+ (context->clip_context->num_constant_cached_bones * (sizeof(Quat_32) + sizeof(Vector4_32)))
+				+ (context->num_cached_bones * 2 * (sizeof(Quat_32) + sizeof(Vector4_32)));
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// Stateless decompression, without any allocation.
+		//
+		// The shared context holds the read-only state of a clip. It is initialized once and never
+		// written afterwards, any number of threads can then sample the clip through it concurrently.
+		// Every thread samples with its own cursor, which holds the state written while seeking and
+		// decompressing. A cursor is small enough to live on the stack for a single call, or it can
+		// be kept by an instance to benefit from the playback cursor between calls.
+		// A cursor is a decompression context, it is used with the regular decompression functions
+		// but must never be deallocated. The decode plan and the caches require allocations and
+		// aren't supported with a shared context.
+		// The compressed clip and the shared context must outlive every cursor that refers to them.
+		//////////////////////////////////////////////////////////////////////////
+		using SharedDecompressionContext = impl::ClipDecompressionContext;
+		using DecompressionCursor = impl::DecompressionContext;
+
+		template<class SettingsType>
+		inline void initialize_shared_decompression_context(const SettingsType& settings, const CompressedClip& clip, SharedDecompressionContext& shared_context)
+		{
+			static_assert(std::is_base_of<DecompressionSettings, SettingsType>::value, "SettingsType must derive from DecompressionSettings!");
+
+			using namespace impl;
+
+			ACL_ENSURE(clip.get_algorithm_type() == AlgorithmType8::UniformlySampled, "Invalid algorithm type [%s], expected [%s]", get_algorithm_name(clip.get_algorithm_type()), get_algorithm_name(AlgorithmType8::UniformlySampled));
+			ACL_ENSURE(clip.is_valid(false), "Clip is invalid");
+			ACL_ENSURE(!settings.use_decode_plan(), "The decode plan isn't supported with a shared decompression context");
+			ACL_ENSURE(!settings.use_key_frame_cache(), "The key frame cache isn't supported with a shared decompression context");
+			ACL_ENSURE(!settings.use_constant_track_cache(), "The constant track cache isn't supported with a shared decompression context");
+
+			initialize_clip_context(settings, get_clip_header(clip), shared_context);
+		}
+
+		inline void initialize_decompression_cursor(const SharedDecompressionContext& shared_context, DecompressionCursor& cursor)
+		{
+			impl::initialize_context(shared_context, cursor);
+		}
+
+		template<class SettingsType, class OutputWriterType>
+		inline void decompress_pose(const SettingsType& settings, const CompressedClip& clip, void* opaque_context, float sample_time, OutputWriterType& writer)
+		{
+			static_assert(std::is_base_of<DecompressionSettings, SettingsType>::value, "SettingsType must derive from DecompressionSettings!");
+			static_assert(std::is_base_of<OutputWriter, OutputWriterType>::value, "OutputWriterType must derive from OutputWriter!");
+
+			using namespace impl;
+
+			ACL_ENSURE(clip.get_algorithm_type() == AlgorithmType8::UniformlySampled, "Invalid algorithm type [%s], expected [%s]", get_algorithm_name(clip.get_algorithm_type()), get_algorithm_name(AlgorithmType8::UniformlySampled));
+			ACL_ENSURE(clip.is_valid(false), "Clip is invalid");
+
+			const ClipHeader& header = get_clip_header(clip);
+
+			DecompressionContext& context = *safe_ptr_cast<DecompressionContext>(opaque_context);
+
+			seek(settings, header, sample_time, context);
+
+			if (settings.use_key_frame_cache())
+			{
+				ACL_ENSURE(context.key_frame_cache_rotations != nullptr, "Decompression context was allocated without a key frame cache");
+
+				update_key_frame_cache(settings, header, context);
+
+				const uint32_t num_bones = header.num_bones;
+				const Quat_32* rotations0 = context.key_frame_cache_rotations;
+				const Quat_32* rotations1 = rotations0 + num_bones;
+				const Vector4_32* translations0 = context.key_frame_cache_translations;
+				const Vector4_32* translations1 = translations0 + num_bones;
+
+				// Default tracks are also flagged as constant, neither needs to be interpolated and neither does a single sampled key frame
+				for (uint32_t bone_index = 0; bone_index < num_bones; ++bone_index)
+				{
+					const uint32_t rotation_track_index = bone_index * Constants::NUM_TRACKS_PER_BONE;
+					if (!writer.skip_all_bone_rotations() && !is_invariant_track_skipped(writer, *context.clip_context, rotation_track_index))
 					{
-						const VectorFormat8 translation_format = settings.get_translation_format(header.translation_format);
-						const RangeReductionFlags8 clip_range_reduction = settings.get_clip_range_reduction(header.clip_range_reduction);
-						const RangeReductionFlags8 segment_range_reduction = settings.get_segment_range_reduction(header.segment_range_reduction);
+						if (bitset_test(context.clip_context->constant_tracks_bitset, context.clip_context->bitset_size, rotation_track_index))
+							writer.write_bone_rotation(bone_index, rotations0[bone_index]);
+						else if (settings.get_sampling_mode() != SamplingMode8::Linear)
+							writer.write_bone_rotation(bone_index, quat_normalize(rotations0[bone_index]));
+						else
+							writer.write_bone_rotation(bone_index, quat_lerp(rotations0[bone_index], rotations1[bone_index], context.interpolation_alpha));
+					}
 
-						Vector4_32 translation0;
-						Vector4_32 translation1;
+					const uint32_t translation_track_index = rotation_track_index + 1;
+					if (!writer.skip_all_bone_translations() && !is_invariant_track_skipped(writer, *context.clip_context, translation_track_index))
+					{
+						if (settings.get_sampling_mode() != SamplingMode8::Linear || bitset_test(context.clip_context->constant_tracks_bitset, context.clip_context->bitset_size, translation_track_index))
+							writer.write_bone_translation(bone_index, translations0[bone_index]);
+						else
+							writer.write_bone_translation(bone_index, vector_lerp(translations0[bone_index], translations1[bone_index], context.interpolation_alpha));
+					}
+				}
 
-						uint8_t bit_rate0;
-						uint8_t bit_rate1;
+				return;
+			}
 
-						if (translation_format == VectorFormat8::Vector3_96 && settings.is_translation_format_supported(VectorFormat8::Vector3_96))
-						{
-							translation0 = unpack_vector3_96(context.animated_track_data0 + context.key_frame_byte_offset0);
-							translation1 = unpack_vector3_96(context.animated_track_data1 + context.key_frame_byte_offset1);
-
-							const uint32_t translation_size = get_packed_vector_size(translation_format);
-							context.key_frame_byte_offset0 += translation_size;
-							context.key_frame_byte_offset1 += translation_size;
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
-								context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
-							}
-						}
-						else if (translation_format == VectorFormat8::Vector3_48 && settings.is_translation_format_supported(VectorFormat8::Vector3_48))
-						{
-							translation0 = unpack_vector3_48(context.animated_track_data0 + context.key_frame_byte_offset0, true);
-							translation1 = unpack_vector3_48(context.animated_track_data1 + context.key_frame_byte_offset1, true);
-
-							const uint32_t translation_size = get_packed_vector_size(translation_format);
-							context.key_frame_byte_offset0 += translation_size;
-							context.key_frame_byte_offset1 += translation_size;
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
-								context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
-							}
-						}
-						else if (translation_format == VectorFormat8::Vector3_32 && settings.is_translation_format_supported(VectorFormat8::Vector3_32))
+			// The decode plan writes the tracks grouped by kind, not in bone order
+			if (settings.use_decode_plan() && !writer.requires_bone_order())
+			{
+				ACL_ENSURE(context.clip_context->decode_plan != nullptr, "Decompression context was allocated without a decode plan");
+
+				const uint16_t* plan_entry = context.clip_context->decode_plan;
+
+				if (!writer.skip_all_bone_rotations() && !writer.skip_default_bone_tracks() && !writer.skip_constant_bone_tracks())
+				{
+					for (uint32_t entry_index = 0; entry_index < context.clip_context->num_default_rotations; ++entry_index)
+						writer.write_bone_rotation(plan_entry[entry_index], quat_identity_32());
+				}
+				plan_entry += context.clip_context->num_default_rotations;
+
+				if (!writer.skip_all_bone_translations() && !writer.skip_default_bone_tracks() && !writer.skip_constant_bone_tracks())
+				{
+					for (uint32_t entry_index = 0; entry_index < context.clip_context->num_default_translations; ++entry_index)
+						writer.write_bone_translation(plan_entry[entry_index], vector_zero_32());
+				}
+				plan_entry += context.clip_context->num_default_translations;
+
+				// Animated tracks don't read the constant track data, they can be skipped as a whole
+				if (writer.skip_constant_bone_tracks())
+				{
+					plan_entry += context.clip_context->num_constant_tracks;
+				}
+				else
+				{
+					for (uint32_t entry_index = 0; entry_index < context.clip_context->num_constant_tracks; ++entry_index)
+					{
+						const uint32_t track_index = *plan_entry++;
+						const uint32_t bone_index = track_index / Constants::NUM_TRACKS_PER_BONE;
+
+						if ((track_index % Constants::NUM_TRACKS_PER_BONE) == 0)
 						{
-							translation0 = unpack_vector3_32(11, 11, 10, true, context.animated_track_data0 + context.key_frame_byte_offset0);
-							translation1 = unpack_vector3_32(11, 11, 10, true, context.animated_track_data1 + context.key_frame_byte_offset1);
-
-							const uint32_t translation_size = get_packed_vector_size(translation_format);
-							context.key_frame_byte_offset0 += translation_size;
-							context.key_frame_byte_offset1 += translation_size;
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_bit_offset0 = context.key_frame_byte_offset0 * 8;
-								context.key_frame_bit_offset1 = context.key_frame_byte_offset1 * 8;
-							}
+							if (writer.skip_all_bone_rotations())
+								skip_constant_rotation(settings, header, context);
+							else
+								writer.write_bone_rotation(bone_index, decompress_constant_rotation(settings, header, context, bone_index));
 						}
-						else if (translation_format == VectorFormat8::Vector3_Variable && settings.is_translation_format_supported(VectorFormat8::Vector3_Variable))
+						else
 						{
-							bit_rate0 = context.format_per_track_data0[context.format_per_track_data_offset];
-							bit_rate1 = context.format_per_track_data1[context.format_per_track_data_offset++];
-							uint8_t num_bits_at_bit_rate0 = get_num_bits_at_bit_rate(bit_rate0);
-							uint8_t num_bits_at_bit_rate1 = get_num_bits_at_bit_rate(bit_rate1);
-
-							if (is_pack_0_bit_rate(bit_rate0))
-								(void)bit_rate0;
-							else if (is_pack_72_bit_rate(bit_rate0))
-								translation0 = unpack_vector3_72(true, context.animated_track_data0, context.key_frame_bit_offset0);
-							else if (is_pack_96_bit_rate(bit_rate0))
-								translation0 = unpack_vector3_96(context.animated_track_data0, context.key_frame_bit_offset0);
+							if (writer.skip_all_bone_translations())
+								skip_constant_translation(settings, header, context);
 							else
-								translation0 = unpack_vector3_n(num_bits_at_bit_rate0, num_bits_at_bit_rate0, num_bits_at_bit_rate0, true, context.animated_track_data0, context.key_frame_bit_offset0);
-
-							if (is_pack_0_bit_rate(bit_rate1))
-								(void)bit_rate1;
-							else if (is_pack_72_bit_rate(bit_rate1))
-								translation1 = unpack_vector3_72(true, context.animated_track_data1, context.key_frame_bit_offset1);
-							else if (is_pack_96_bit_rate(bit_rate1))
-								translation1 = unpack_vector3_96(context.animated_track_data1, context.key_frame_bit_offset1);
-							else
-								translation1 = unpack_vector3_n(num_bits_at_bit_rate1, num_bits_at_bit_rate1, num_bits_at_bit_rate1, true, context.animated_track_data1, context.key_frame_bit_offset1);
-
-							uint8_t num_bits_read0 = num_bits_at_bit_rate0 * 3;
-							uint8_t num_bits_read1 = num_bits_at_bit_rate1 * 3;
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								num_bits_read0 = align_to(num_bits_read0, MIXED_PACKING_ALIGNMENT_NUM_BITS);
-								num_bits_read1 = align_to(num_bits_read1, MIXED_PACKING_ALIGNMENT_NUM_BITS);
-							}
-
-							context.key_frame_bit_offset0 += num_bits_read0;
-							context.key_frame_bit_offset1 += num_bits_read1;
-
-							if (settings.supports_mixed_packing() && context.has_mixed_packing)
-							{
-								context.key_frame_byte_offset0 = context.key_frame_bit_offset0 / 8;
-								context.key_frame_byte_offset1 = context.key_frame_bit_offset1 / 8;
-							}
+								writer.write_bone_translation(bone_index, decompress_constant_translation(settings, header, context, bone_index));
 						}
+					}
+				}
 
-						if (is_enum_flag_set(segment_range_reduction, RangeReductionFlags8::Translations))
-						{
-#if ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BIT_SIZE == 8
-							if (translation_format == VectorFormat8::Vector3_Variable && settings.is_translation_format_supported(VectorFormat8::Vector3_Variable) && is_pack_0_bit_rate(bit_rate0))
-								translation0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset, true);
-							else
-							{
-								Vector4_32 segment_range_min0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector3_24(context.segment_range_data0 + context.segment_range_data_offset + (3 * sizeof(uint8_t)), true);
+				for (uint32_t entry_index = 0; entry_index < context.clip_context->num_animated_tracks; ++entry_index)
+				{
+					const uint32_t track_index = *plan_entry++;
+					const uint32_t bone_index = track_index / Constants::NUM_TRACKS_PER_BONE;
 
-								translation0 = vector_mul_add(translation0, segment_range_extent0, segment_range_min0);
-							}
+					if ((track_index % Constants::NUM_TRACKS_PER_BONE) == 0)
+					{
+						if (writer.skip_all_bone_rotations())
+							skip_animated_rotation(settings, header, context);
+						else
+							writer.write_bone_rotation(bone_index, decompress_animated_rotation(settings, header, context));
+					}
+					else
+					{
+						if (writer.skip_all_bone_translations())
+							skip_animated_translation(settings, header, context);
+						else
+							writer.write_bone_translation(bone_index, decompress_animated_translation(settings, header, context));
+					}
+				}
 
-							if (translation_format == VectorFormat8::Vector3_Variable && settings.is_translation_format_supported(VectorFormat8::Vector3_Variable) && is_pack_0_bit_rate(bit_rate1))
-								translation1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset, true);
-							else
-							{
-								Vector4_32 segment_range_min1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector3_24(context.segment_range_data1 + context.segment_range_data_offset + (3 * sizeof(uint8_t)), true);
+				return;
+			}
 
-								translation1 = vector_mul_add(translation1, segment_range_extent1, segment_range_min1);
-							}
-#else
-							if (translation_format == VectorFormat8::Vector3_Variable && settings.is_translation_format_supported(VectorFormat8::Vector3_Variable) && is_pack_0_bit_rate(bit_rate0))
-								translation0 = unpack_vector3_96(context.segment_range_data0 + context.segment_range_data_offset,);
-							else
-							{
-								Vector4_32 segment_range_min0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent0 = unpack_vector3_48(context.segment_range_data0 + context.segment_range_data_offset + (3 * sizeof(uint16_t)), true);
+			for (uint32_t bone_index = 0; bone_index < header.num_bones; ++bone_index)
+			{
+				// Skipping a default track only steps over its bitset entries
+				if (writer.skip_all_bone_rotations() || is_invariant_track_skipped(writer, *context.clip_context, context.default_track_offset))
+					skip_rotation(settings, header, context);
+				else
+				{
+					Quat_32 rotation = decompress_rotation(settings, header, context);
+					writer.write_bone_rotation(bone_index, rotation);
+				}
 
-								translation0 = vector_mul_add(translation0, segment_range_extent0, segment_range_min0);
-							}
+				if (writer.skip_all_bone_translations() || is_invariant_track_skipped(writer, *context.clip_context, context.default_track_offset))
+					skip_translation(settings, header, context);
+				else
+				{
+					Vector4_32 translation = decompress_translation(settings, header, context);
+					writer.write_bone_translation(bone_index, translation);
+				}
+			}
+		}
 
-							if (translation_format == VectorFormat8::Vector3_Variable && settings.is_translation_format_supported(VectorFormat8::Vector3_Variable) && is_pack_0_bit_rate(bit_rate1))
-								translation1 = unpack_vector3_96(context.segment_range_data1 + context.segment_range_data_offset);
-							else
-							{
-								Vector4_32 segment_range_min1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset, true);
-								Vector4_32 segment_range_extent1 = unpack_vector3_48(context.segment_range_data1 + context.segment_range_data_offset + (3 * sizeof(uint16_t)), true);
+		// A bone mask selects the bones to decompress for a clip, typically one mask per level of detail.
+		// It is built once from a sorted list of bone indices and can be shared by every context of the clip.
+		template<class SettingsType>
+		inline void* allocate_bone_mask(Allocator& allocator, const SettingsType& settings, const CompressedClip& clip, const uint16_t* bone_indices, uint16_t num_bone_indices)
+		{
+			static_assert(std::is_base_of<DecompressionSettings, SettingsType>::value, "SettingsType must derive from DecompressionSettings!");
 
-								translation1 = vector_mul_add(translation1, segment_range_extent1, segment_range_min1);
-							}
-#endif
+			using namespace impl;
 
-							context.segment_range_data_offset += 3 * ACL_PER_SEGMENT_RANGE_REDUCTION_COMPONENT_BYTE_SIZE * 2;
-						}
+			ACL_ENSURE(clip.get_algorithm_type() == AlgorithmType8::UniformlySampled, "Invalid algorithm type [%s], expected [%s]", get_algorithm_name(clip.get_algorithm_type()), get_algorithm_name(AlgorithmType8::UniformlySampled));
+			ACL_ENSURE(clip.is_valid(false), "Clip is invalid");
 
-						if (is_enum_flag_set(clip_range_reduction, RangeReductionFlags8::Translations))
-						{
-							Vector4_32 clip_range_min = unpack_vector3_96(context.clip_range_data + context.clip_range_data_offset);
-							Vector4_32 clip_range_extent = unpack_vector3_96(context.clip_range_data + context.clip_range_data_offset + (3 * sizeof(float)));
+			BoneMask* bone_mask = allocate_type<BoneMask>(allocator);
+			bone_mask->entries = allocate_type_array<BoneMaskEntry>(allocator, num_bone_indices);
 
-							translation0 = vector_mul_add(translation0, clip_range_extent, clip_range_min);
-							translation1 = vector_mul_add(translation1, clip_range_extent, clip_range_min);
+			build_bone_mask(settings, get_clip_header(clip), bone_indices, num_bone_indices, *bone_mask);
 
-							context.clip_range_data_offset += 3 * sizeof(float) * 2;
-						}
+			return bone_mask;
+		}
+
+		inline void deallocate_bone_mask(Allocator& allocator, void* opaque_bone_mask)
+		{
+			using namespace impl;
+
+			BoneMask* bone_mask = safe_ptr_cast<BoneMask>(opaque_bone_mask);
+			deallocate_type_array(allocator, bone_mask->entries, bone_mask->num_entries);
+			deallocate_type<BoneMask>(allocator, bone_mask);
+		}
+
+		// Decompresses only the bones of the provided mask, the other bones are never written.
+		// The offsets of every masked bone are read from the mask, only the bit rates of the
+		// variable tracks in between need to be summed since they change with every segment.
+		template<class SettingsType, class OutputWriterType>
+		inline void decompress_partial_pose(const SettingsType& settings, const CompressedClip& clip, void* opaque_context, const void* opaque_bone_mask, float sample_time, OutputWriterType& writer)
+		{
+			static_assert(std::is_base_of<DecompressionSettings, SettingsType>::value, "SettingsType must derive from DecompressionSettings!");
+			static_assert(std::is_base_of<OutputWriter, OutputWriterType>::value, "OutputWriterType must derive from OutputWriter!");
+
+			using namespace impl;
+
+			ACL_ENSURE(clip.get_algorithm_type() == AlgorithmType8::UniformlySampled, "Invalid algorithm type [%s], expected [%s]", get_algorithm_name(clip.get_algorithm_type()), get_algorithm_name(AlgorithmType8::UniformlySampled));
+			ACL_ENSURE(clip.is_valid(false), "Clip is invalid");
+
+			const ClipHeader& header = get_clip_header(clip);
+
+			DecompressionContext& context = *safe_ptr_cast<DecompressionContext>(opaque_context);
+			const BoneMask& bone_mask = *safe_ptr_cast<const BoneMask>(opaque_bone_mask);
+
+			ACL_ENSURE(bone_mask.constant_tracks_bitset == context.clip_context->constant_tracks_bitset, "Bone mask was not built for this clip");
+
+			seek(settings, header, sample_time, context);
+
+			decompress_bone_mask(settings, header, bone_mask, false, context, writer);
+		}
+
+		// Decompresses the pose of many instances playing the same clip at their own sample time.
+		// Every context must have been allocated for this clip, one per instance, along with one writer per instance.
+		// The bitsets are walked once for the whole batch and constant tracks are only unpacked once,
+		// only animated tracks are decompressed for every instance.
+		template<class SettingsType, class OutputWriterType>
+		inline void decompress_poses(const SettingsType& settings, const CompressedClip& clip, void* const* opaque_contexts, const float* sample_times, OutputWriterType* writers, uint32_t num_instances)
+		{
+			static_assert(std::is_base_of<DecompressionSettings, SettingsType>::value, "SettingsType must derive from DecompressionSettings!");
+			static_assert(std::is_base_of<OutputWriter, OutputWriterType>::value, "OutputWriterType must derive from OutputWriter!");
+
+			using namespace impl;
+
+			ACL_ENSURE(clip.get_algorithm_type() == AlgorithmType8::UniformlySampled, "Invalid algorithm type [%s], expected [%s]", get_algorithm_name(clip.get_algorithm_type()), get_algorithm_name(AlgorithmType8::UniformlySampled));
+			ACL_ENSURE(clip.is_valid(false), "Clip is invalid");
+
+			if (num_instances == 0)
+				return;
+
+			const ClipHeader& header = get_clip_header(clip);
+
+			for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+			{
+				DecompressionContext& context = *safe_ptr_cast<DecompressionContext>(opaque_contexts[instance_index]);
+				ACL_ENSURE(context.clip_context->segment_headers == header.get_segment_headers(), "Decompression context %u was not allocated for this clip", instance_index);
 
-						translation = vector_lerp(translation0, translation1, context.interpolation_alpha);
+				seek(settings, header, sample_times[instance_index], context);
+			}
+
+			// The first context walks the bitsets and the constant track data on behalf of every instance
+			DecompressionContext& lead_context = *safe_ptr_cast<DecompressionContext>(opaque_contexts[0]);
+
+			const uint32_t num_tracks = header.num_bones * Constants::NUM_TRACKS_PER_BONE;
+			for (uint32_t track_index = 0; track_index < num_tracks; ++track_index)
+			{
+				const uint32_t bone_index = track_index / Constants::NUM_TRACKS_PER_BONE;
+				const bool is_rotation = (track_index % Constants::NUM_TRACKS_PER_BONE) == 0;
+				const bool is_skipped = is_rotation ? writers[0].skip_all_bone_rotations() : writers[0].skip_all_bone_translations();
+
+				if (is_skipped)
+				{
+					if (bitset_test(lead_context.clip_context->default_tracks_bitset, lead_context.clip_context->bitset_size, track_index))
+						continue;
+
+					if (bitset_test(lead_context.clip_context->constant_tracks_bitset, lead_context.clip_context->bitset_size, track_index))
+					{
+						if (is_rotation)
+							skip_constant_rotation(settings, header, lead_context);
+						else
+							skip_constant_translation(settings, header, lead_context);
+						continue;
+					}
 
-						ACL_ENSURE(vector_is_finite3(translation), "Translation is not valid!");
+					for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+					{
+						DecompressionContext& context = *safe_ptr_cast<DecompressionContext>(opaque_contexts[instance_index]);
+						if (is_rotation)
+							skip_animated_rotation(settings, header, context);
+						else
+							skip_animated_translation(settings, header, context);
 					}
+					continue;
 				}
 
-				context.default_track_offset++;
-				context.constant_track_offset++;
-				return translation;
+				if (bitset_test(lead_context.clip_context->default_tracks_bitset, lead_context.clip_context->bitset_size, track_index))
+				{
+					if (writers[0].skip_default_bone_tracks())
+						continue;
+
+					if (is_rotation)
+					{
+						const Quat_32 rotation = quat_identity_32();
+						for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+						{
+							if (!writers[instance_index].skip_constant_bone_tracks())
+								writers[instance_index].write_bone_rotation(bone_index, rotation);
+						}
+					}
+					else
+					{
+						const Vector4_32 translation = vector_zero_32();
+						for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+						{
+							if (!writers[instance_index].skip_constant_bone_tracks())
+								writers[instance_index].write_bone_translation(bone_index, translation);
+						}
+					}
+				}
+				else if (bitset_test(lead_context.clip_context->constant_tracks_bitset, lead_context.clip_context->bitset_size, track_index))
+				{
+					if (is_rotation)
+					{
+						const Quat_32 rotation = decompress_constant_rotation(settings, header, lead_context, bone_index);
+						for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+						{
+							if (!writers[instance_index].skip_constant_bone_tracks())
+								writers[instance_index].write_bone_rotation(bone_index, rotation);
+						}
+					}
+					else
+					{
+						const Vector4_32 translation = decompress_constant_translation(settings, header, lead_context, bone_index);
+						for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+						{
+							if (!writers[instance_index].skip_constant_bone_tracks())
+								writers[instance_index].write_bone_translation(bone_index, translation);
+						}
+					}
+				}
+				else if (is_rotation)
+				{
+					for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+					{
+						DecompressionContext& context = *safe_ptr_cast<DecompressionContext>(opaque_contexts[instance_index]);
+						writers[instance_index].write_bone_rotation(bone_index, decompress_animated_rotation(settings, header, context));
+					}
+				}
+				else
+				{
+					for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+					{
+						DecompressionContext& context = *safe_ptr_cast<DecompressionContext>(opaque_contexts[instance_index]);
+						writers[instance_index].write_bone_translation(bone_index, decompress_animated_translation(settings, header, context));
+					}
+				}
 			}
 		}
 
-		//////////////////////////////////////////////////////////////////////////
-		// Deriving from this struct and overriding these constexpr functions
-		// allow you to control which code is stripped for maximum performance.
-		// With these, you can:
-		//    - Support only a subset of the formats and statically strip the rest
-		//    - Force a single format and statically strip the rest
-		//    - Decide all of this at runtime by not making the overrides constexpr
-		//
-		// By default, all formats are supported.
-		//////////////////////////////////////////////////////////////////////////
-		struct DecompressionSettings
+		// Decompresses two clips and writes their blended local pose, without intermediate pose buffers.
+		// Both clips must have the same number of bones and each has its own decompression context.
+		// The blend weight is the contribution of the second clip, optionally scaled per bone by the
+		// provided bone weights to only blend part of the skeleton. Bones are decompressed from both
+		// clips in turn, a clip that doesn't contribute to a bone skips its tracks entirely.
+		template<class SettingsType, class OutputWriterType>
+		inline void decompress_blended_pose(const SettingsType& settings,
+			const CompressedClip& clip0, void* opaque_context0, float sample_time0,
+			const CompressedClip& clip1, void* opaque_context1, float sample_time1,
+			float blend_weight, const float* bone_weights, OutputWriterType& writer)
 		{
-			constexpr bool is_rotation_format_supported(RotationFormat8 format) const { return true; }
-			constexpr bool is_translation_format_supported(VectorFormat8 format) const { return true; }
-			constexpr RotationFormat8 get_rotation_format(RotationFormat8 format) const { return format; }
-			constexpr VectorFormat8 get_translation_format(VectorFormat8 format) const { return format; }
+			static_assert(std::is_base_of<DecompressionSettings, SettingsType>::value, "SettingsType must derive from DecompressionSettings!");
+			static_assert(std::is_base_of<OutputWriter, OutputWriterType>::value, "OutputWriterType must derive from OutputWriter!");
 
-			constexpr bool are_clip_range_reduction_flags_supported(RangeReductionFlags8 flags) const { return true; }
-			constexpr bool are_segment_range_reduction_flags_supported(RangeReductionFlags8 flags) const { return true; }
-			constexpr RangeReductionFlags8 get_clip_range_reduction(RangeReductionFlags8 flags) const { return flags; }
-			constexpr RangeReductionFlags8 get_segment_range_reduction(RangeReductionFlags8 flags) const { return flags; }
+			using namespace impl;
 
-			// Whether tracks must all be variable or all fixed width, or if they can be mixed and require padding
-			constexpr bool supports_mixed_packing() const { return true; }
-		};
+			ACL_ENSURE(clip0.get_algorithm_type() == AlgorithmType8::UniformlySampled, "Invalid algorithm type [%s], expected [%s]", get_algorithm_name(clip0.get_algorithm_type()), get_algorithm_name(AlgorithmType8::UniformlySampled));
+			ACL_ENSURE(clip1.get_algorithm_type() == AlgorithmType8::UniformlySampled, "Invalid algorithm type [%s], expected [%s]", get_algorithm_name(clip1.get_algorithm_type()), get_algorithm_name(AlgorithmType8::UniformlySampled));
+			ACL_ENSURE(clip0.is_valid(false), "Clip is invalid");
+			ACL_ENSURE(clip1.is_valid(false), "Clip is invalid");
+			ACL_ENSURE(blend_weight >= 0.0f && blend_weight <= 1.0f, "Invalid blend weight: %f", blend_weight);
 
-		template<class SettingsType>
-		inline void* allocate_decompression_context(Allocator& allocator, const SettingsType& settings, const CompressedClip& clip)
-		{
-			using namespace impl;
+			const ClipHeader& header0 = get_clip_header(clip0);
+			const ClipHeader& header1 = get_clip_header(clip1);
+
+			ACL_ENSURE(header0.num_bones == header1.num_bones, "Blended clips must have the same number of bones: %u != %u", header0.num_bones, header1.num_bones);
+
+			DecompressionContext& context0 = *safe_ptr_cast<DecompressionContext>(opaque_context0);
+			DecompressionContext& context1 = *safe_ptr_cast<DecompressionContext>(opaque_context1);
+
+			seek(settings, header0, sample_time0, context0);
+			seek(settings, header1, sample_time1, context1);
 
-			DecompressionContext* context = allocate_type<DecompressionContext>(allocator);
+			for (uint32_t bone_index = 0; bone_index < header0.num_bones; ++bone_index)
+			{
+				const float bone_weight = bone_weights != nullptr ? (blend_weight * bone_weights[bone_index]) : blend_weight;
+				const bool use_clip0 = bone_weight < 1.0f;
+				const bool use_clip1 = bone_weight > 0.0f;
+
+				if (writer.skip_all_bone_rotations())
+				{
+					skip_rotation(settings, header0, context0);
+					skip_rotation(settings, header1, context1);
+				}
+				else
+				{
+					Quat_32 rotation;
+					if (use_clip0 && use_clip1)
+					{
+						const Quat_32 rotation0 = decompress_rotation(settings, header0, context0);
+						const Quat_32 rotation1 = decompress_rotation(settings, header1, context1);
+						rotation = quat_lerp(rotation0, rotation1, bone_weight);
+					}
+					else if (use_clip0)
+					{
+						rotation = decompress_rotation(settings, header0, context0);
+						skip_rotation(settings, header1, context1);
+					}
+					else
+					{
+						skip_rotation(settings, header0, context0);
+						rotation = decompress_rotation(settings, header1, context1);
+					}
 
-			ACL_ASSERT(is_aligned_to(&context->segment_headers, CONTEXT_ALIGN_AS), "Read-only decompression context is misaligned");
-			ACL_ASSERT(is_aligned_to(&context->constant_track_offset, CONTEXT_ALIGN_AS), "Read-write decompression context is misaligned");
+					writer.write_bone_rotation(bone_index, rotation);
+				}
 
-			initialize_context(settings, get_clip_header(clip), *context);
+				if (writer.skip_all_bone_translations())
+				{
+					skip_translation(settings, header0, context0);
+					skip_translation(settings, header1, context1);
+				}
+				else
+				{
+					Vector4_32 translation;
+					if (use_clip0 && use_clip1)
+					{
+						const Vector4_32 translation0 = decompress_translation(settings, header0, context0);
+						const Vector4_32 translation1 = decompress_translation(settings, header1, context1);
+						translation = vector_lerp(translation0, translation1, bone_weight);
+					}
+					else if (use_clip0)
+					{
+						translation = decompress_translation(settings, header0, context0);
+						skip_translation(settings, header1, context1);
+					}
+					else
+					{
+						skip_translation(settings, header0, context0);
+						translation = decompress_translation(settings, header1, context1);
+					}
 
-			return context;
+					writer.write_bone_translation(bone_index, translation);
+				}
+			}
 		}
 
-		inline void deallocate_decompression_context(Allocator& allocator, void* opaque_context)
+		// Decompresses a few bones of a clip at several sample times, e.g. for motion matching queries.
+		// The bones are provided as a mask built once with allocate_bone_mask(..) and only those are decompressed.
+		// The sample times are visited in increasing order, in groups of up to 64, so consecutive seeks can reuse
+		// their segment and key frames. The output holds one transform per masked bone for every sample time,
+		// in the order the sample times were provided and the bone indices were provided to the mask.
+		template<class SettingsType>
+		inline void decompress_bones_at_times(const SettingsType& settings, const CompressedClip& clip, void* opaque_context,
+			const void* opaque_bone_mask, const float* sample_times, uint32_t num_sample_times,
+			Transform_32* out_transforms)
 		{
+			static_assert(std::is_base_of<DecompressionSettings, SettingsType>::value, "SettingsType must derive from DecompressionSettings!");
+
 			using namespace impl;
 
-			DecompressionContext* context = safe_ptr_cast<DecompressionContext>(opaque_context);
-			deallocate_type<DecompressionContext>(allocator, context);
+			ACL_ENSURE(clip.get_algorithm_type() == AlgorithmType8::UniformlySampled, "Invalid algorithm type [%s], expected [%s]", get_algorithm_name(clip.get_algorithm_type()), get_algorithm_name(AlgorithmType8::UniformlySampled));
+			ACL_ENSURE(clip.is_valid(false), "Clip is invalid");
+
+			const ClipHeader& header = get_clip_header(clip);
+
+			DecompressionContext& context = *safe_ptr_cast<DecompressionContext>(opaque_context);
+			const BoneMask& bone_mask = *safe_ptr_cast<const BoneMask>(opaque_bone_mask);
+
+			ACL_ENSURE(context.clip_context->segment_headers == header.get_segment_headers(), "Decompression context was not allocated for this clip");
+			ACL_ENSURE(bone_mask.constant_tracks_bitset == context.clip_context->constant_tracks_bitset, "Bone mask was not built for this clip");
+
+			if (bone_mask.num_entries == 0)
+				return;
+
+			const PlaybackCursorSettings<SettingsType> cursor_settings(settings);
+
+			for (uint32_t first_time_index = 0; first_time_index < num_sample_times; first_time_index += NUM_SORTED_SAMPLE_TIMES)
+			{
+				const uint32_t num_group_sample_times = std::min<uint32_t>(num_sample_times - first_time_index, NUM_SORTED_SAMPLE_TIMES);
+				const float* group_sample_times = sample_times + first_time_index;
+
+				// Sort the sample times, there are only a handful of them
+				uint8_t sorted_time_indices[NUM_SORTED_SAMPLE_TIMES];
+				for (uint32_t time_index = 0; time_index < num_group_sample_times; ++time_index)
+				{
+					uint32_t insert_index = time_index;
+					for (; insert_index > 0 && group_sample_times[sorted_time_indices[insert_index - 1]] > group_sample_times[time_index]; --insert_index)
+						sorted_time_indices[insert_index] = sorted_time_indices[insert_index - 1];
+
+					sorted_time_indices[insert_index] = safe_static_cast<uint8_t>(time_index);
+				}
+
+				for (uint32_t sorted_index = 0; sorted_index < num_group_sample_times; ++sorted_index)
+				{
+					const uint32_t time_index = first_time_index + sorted_time_indices[sorted_index];
+
+					seek(cursor_settings, header, sample_times[time_index], context);
+
+					DefaultOutputWriter writer(out_transforms + (time_index * bone_mask.num_entries), bone_mask.num_entries);
+					decompress_bone_mask(settings, header, bone_mask, true, context, writer);
+				}
+			}
 		}
 
-		template<class SettingsType, class OutputWriterType>
-		inline void decompress_pose(const SettingsType& settings, const CompressedClip& clip, void* opaque_context, float sample_time, OutputWriterType& writer)
+		// Returns the root motion between two sample times, the root transform at the end sample time
+		// is transform_mul(delta, root transform at the start sample time).
+		// A looping clip with an end sample time before its start sample time wraps around the end of the clip.
+		// Only the root tracks are decompressed and the seeks reuse the segment and key frames when they can.
+		template<class SettingsType>
+		inline Transform_32 decompress_root_motion_delta(const SettingsType& settings, const CompressedClip& clip, void* opaque_context, float start_sample_time, float end_sample_time, bool is_looping)
 		{
 			static_assert(std::is_base_of<DecompressionSettings, SettingsType>::value, "SettingsType must derive from DecompressionSettings!");
-			static_assert(std::is_base_of<OutputWriter, OutputWriterType>::value, "OutputWriterType must derive from OutputWriter!");
 
 			using namespace impl;
 
@@ -975,17 +1956,25 @@ namespace acl
 			const ClipHeader& header = get_clip_header(clip);
 
 			DecompressionContext& context = *safe_ptr_cast<DecompressionContext>(opaque_context);
+			const PlaybackCursorSettings<SettingsType> cursor_settings(settings);
 
-			seek(settings, header, sample_time, context);
+			const Transform_32 start_transform = decompress_root_transform(cursor_settings, header, start_sample_time, context);
 
-			for (uint32_t bone_index = 0; bone_index < header.num_bones; ++bone_index)
+			if (is_looping && end_sample_time < start_sample_time)
 			{
-				Quat_32 rotation = decompress_rotation(settings, header, context);
-				writer.write_bone_rotation(bone_index, rotation);
-
-				Vector4_32 translation = decompress_translation(settings, header, context);
-				writer.write_bone_translation(bone_index, translation);
+				// Up to the end of the clip, then from its start
+				const Transform_32 last_transform = decompress_root_transform(cursor_settings, header, context.clip_context->clip_duration, context);
+				const Transform_32 first_transform = decompress_root_transform(cursor_settings, header, 0.0f, context);
+				const Transform_32 end_transform = decompress_root_transform(cursor_settings, header, end_sample_time, context);
+
+				const Transform_32 delta_to_last = calculate_root_motion_delta(start_transform, last_transform);
+				const Transform_32 delta_from_first = calculate_root_motion_delta(first_transform, end_transform);
+				const Transform_32 delta = transform_mul(delta_from_first, delta_to_last);
+				return transform_set(quat_normalize(delta.rotation), delta.translation);
 			}
+
+			const Transform_32 end_transform = decompress_root_transform(cursor_settings, header, end_sample_time, context);
+			return calculate_root_motion_delta(start_transform, end_transform);
 		}
 
 		template<class SettingsType>
@@ -1004,16 +1993,7 @@ namespace acl
 
 			seek(settings, header, sample_time, context);
 
-			// TODO: Optimize this by counting the number of bits set, we can use the pop-count instruction on
-			// architectures that support it (e.g. xb1/ps4). This would entirely avoid looping here.
-			for (uint32_t bone_index = 0; bone_index < header.num_bones; ++bone_index)
-			{
-				if (bone_index == sample_bone_index)
-					break;
-
-				skip_rotation(settings, header, context);
-				skip_translation(settings, header, context);
-			}
+			skip_to_bone(settings, header, sample_bone_index, context);
 
 			// TODO: Skip if not interested in return value
 			Quat_32 rotation = decompress_rotation(settings, header, context);
@@ -54,6 +54,7 @@
 
 #include <stdint.h>
 #include <cstdio>
+#include <cstring>
 
 //////////////////////////////////////////////////////////////////////////
 // Full Precision Encoder
@@ -82,11 +83,17 @@ namespace acl
 
 			SegmentingSettings segmenting;
 
+			// Number of threads searching the bit rates of variable bit rate formats concurrently, across segments then bones.
+			// The compressed clip is identical regardless of the number of threads, it isn't part of the hash.
+			// The allocator must be thread safe when more than one thread is used.
+			uint16_t num_quantization_threads;
+
 			CompressionSettings()
 				: rotation_format(RotationFormat8::Quat_128)
 				, translation_format(VectorFormat8::Vector3_96)
 				, range_reduction(RangeReductionFlags8::None)
 				, segmenting()
+				, num_quantization_threads(1)
 			{}
 
 			uint32_t hash() const
@@ -117,6 +124,15 @@ namespace acl
 				}
 			}
 
+			inline void write_segment_start_indices(const ClipContext& clip_context, uint32_t* segment_start_indices)
+			{
+				for (uint16_t segment_index = 0; segment_index < clip_context.num_segments; ++segment_index)
+				{
+					const SegmentContext& segment = clip_context.segments[segment_index];
+					segment_start_indices[segment_index] = segment.clip_sample_offset;
+				}
+			}
+
 			inline void write_segment_data(const ClipContext& clip_context, const CompressionSettings& settings, ClipHeader& header)
 			{
 				SegmentHeader* segment_headers = header.get_segment_headers();
@@ -180,23 +196,32 @@ namespace acl
 			ClipContext clip_context;
 			initialize_clip_context(allocator, clip, skeleton, clip_context);
 
+			ScopeProfiler conversion_time;
 			convert_rotation_streams(allocator, clip_context, settings.rotation_format);
+			conversion_time.stop();
 
 			// Extract our clip ranges now, we need it for compacting the constant streams
+			ScopeProfiler range_extraction_time;
 			extract_clip_bone_ranges(allocator, clip_context);
+			range_extraction_time.stop();
 
 			// TODO: Expose this, especially the translation threshold depends on the unit scale.
 			// Centimeters VS meters, a different threshold should be used. Perhaps we should pass an
 			// argument to the compression algorithm that states the units used or we should force centimeters
+			ScopeProfiler constant_compaction_time;
 			compact_constant_streams(allocator, clip_context, 0.00001f, 0.001f);
+			constant_compaction_time.stop();
 
+			ScopeProfiler normalization_time;
 			uint32_t clip_range_data_size = 0;
 			if (settings.range_reduction != RangeReductionFlags8::None)
 			{
 				normalize_clip_streams(clip_context, settings.range_reduction);
 				clip_range_data_size = get_stream_range_data_size(clip_context, settings.range_reduction, settings.rotation_format, settings.translation_format);
 			}
+			normalization_time.stop();
 
+			ScopeProfiler segmenting_time;
 			if (settings.segmenting.enabled)
 			{
 				segment_streams(allocator, clip_context, settings.segmenting);
@@ -207,8 +232,13 @@ namespace acl
 					normalize_segment_streams(clip_context, settings.range_reduction);
 				}
 			}
+			segmenting_time.stop();
+
+			ScopeProfiler quantization_time;
+			quantize_streams(allocator, clip_context, settings.rotation_format, settings.translation_format, clip, skeleton, raw_clip_context, settings.num_quantization_threads);
+			quantization_time.stop();
 
-			quantize_streams(allocator, clip_context, settings.rotation_format, settings.translation_format, clip, skeleton, raw_clip_context);
+			ScopeProfiler writing_time;
 
 			const SegmentContext& clip_segment = clip_context.segments[0];
 
@@ -227,6 +257,7 @@ namespace acl
 			buffer_size += sizeof(CompressedClip);
 			buffer_size += sizeof(ClipHeader);
 			buffer_size += sizeof(SegmentHeader) * clip_context.num_segments;	// Segment headers
+			buffer_size += sizeof(uint32_t) * clip_context.num_segments;		// Segment start indices
 			buffer_size += sizeof(uint32_t) * bitset_size;		// Default tracks bitset
 			buffer_size += sizeof(uint32_t) * bitset_size;		// Constant tracks bitset
 			buffer_size = align_to(buffer_size, 4);				// Align constant track data
@@ -245,6 +276,9 @@ namespace acl
 
 			uint8_t* buffer = allocate_type_array_aligned<uint8_t>(allocator, buffer_size, 16);
 
+			// Clear the buffer so the alignment padding is deterministic, identical inputs yield identical clips
+			std::memset(buffer, 0, buffer_size);
+
 			CompressedClip* compressed_clip = make_compressed_clip(buffer, buffer_size, AlgorithmType8::UniformlySampled);
 
 			ClipHeader& header = get_clip_header(*compressed_clip);
@@ -257,13 +291,15 @@ namespace acl
 			header.num_samples = num_samples;
 			header.sample_rate = clip.get_sample_rate();
 			header.segment_headers_offset = sizeof(ClipHeader);
-			header.default_tracks_bitset_offset = header.segment_headers_offset + (sizeof(SegmentHeader) * clip_context.num_segments);
+			header.segment_start_indices_offset = header.segment_headers_offset + (sizeof(SegmentHeader) * clip_context.num_segments);
+			header.default_tracks_bitset_offset = header.segment_start_indices_offset + (sizeof(uint32_t) * clip_context.num_segments);
 			header.constant_tracks_bitset_offset = header.default_tracks_bitset_offset + (sizeof(uint32_t) * bitset_size);
 			header.constant_track_data_offset = align_to(header.constant_tracks_bitset_offset + (sizeof(uint32_t) * bitset_size), 4);	// Aligned to 4 bytes
 			header.clip_range_data_offset = align_to(header.constant_track_data_offset + constant_data_size, 4);						// Aligned to 4 bytes
 
 			uint16_t segment_headers_start_offset = header.clip_range_data_offset + clip_range_data_size;
 			impl::write_segment_headers(clip_context, settings, header.get_segment_headers(), segment_headers_start_offset);
+			impl::write_segment_start_indices(clip_context, header.get_segment_start_indices());
 			write_default_track_bitset(clip_context, header.get_default_tracks_bitset(), bitset_size);
 			write_constant_track_bitset(clip_context, header.get_constant_tracks_bitset(), bitset_size);
 
@@ -281,6 +317,7 @@ namespace acl
 
 			finalize_compressed_clip(*compressed_clip);
 
+			writing_time.stop();
 			compression_time.stop();
 
 			if (stats.get_logging() != StatLogging::None)
@@ -324,6 +361,22 @@ namespace acl
 				writer["worst_bone"] = error.index;
 				writer["worst_time"] = error.sample_time;
 				writer["compression_time"] = cycles_to_seconds(compression_time.get_elapsed_cycles());
+				writer["num_quantization_threads"] = settings.num_quantization_threads;
+				writer["compression_stage_times"] = [&](SJSONObjectWriter& writer)
+				{
+					writer["rotation_conversion"] = cycles_to_seconds(conversion_time.get_elapsed_cycles());
+					writer["range_extraction"] = cycles_to_seconds(range_extraction_time.get_elapsed_cycles());
+					writer["constant_compaction"] = cycles_to_seconds(constant_compaction_time.get_elapsed_cycles());
+					writer["normalization"] = cycles_to_seconds(normalization_time.get_elapsed_cycles());
+					writer["segmenting"] = cycles_to_seconds(segmenting_time.get_elapsed_cycles());
+					writer["quantization"] = cycles_to_seconds(quantization_time.get_elapsed_cycles());
+					writer["writing"] = cycles_to_seconds(writing_time.get_elapsed_cycles());
+				};
+				writer["lossy_sample_cache_peak_sizes"] = [&](SJSONArrayWriter& writer)
+				{
+					for (const SegmentContext& segment : clip_context.segment_iterator())
+						writer.push_value(segment.lossy_sample_cache_peak_size);
+				};
 				writer["duration"] = clip.get_duration();
 				writer["num_samples"] = clip.get_num_samples();
 				writer["rotation_format"] = get_rotation_format_name(settings.rotation_format);
@@ -31,6 +31,7 @@
 #include "acl/math/transform_32.h"
 
 #include <stdint.h>
+#include <algorithm>
 
 namespace acl
 {
@@ -90,6 +91,8 @@ namespace acl
 		RigidSkeleton(Allocator& allocator, RigidBone* bones, uint16_t num_bones)
 			: m_allocator(allocator)
 			, m_bones(allocate_type_array<RigidBone>(allocator, num_bones))
+			, m_bone_chain_offsets(allocate_type_array<uint32_t>(allocator, size_t(num_bones) + 1))
+			, m_bone_chains(nullptr)
 			, m_num_bones(num_bones)
 		{
 			// Copy and validate the input data
@@ -112,10 +115,34 @@ namespace acl
 			}
 
 			ACL_ENSURE(found_root, "No root bone found. The root bone must have a parent index = 0xFFFF");
+
+			// Since bones are sorted parent first, the chain of a bone is the chain of its parent followed by the bone itself
+			m_bone_chain_offsets[0] = 0;
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			{
+				const uint16_t parent_index = m_bones[bone_index].parent_index;
+				const uint32_t parent_chain_length = parent_index == INVALID_BONE_INDEX ? 0 : (m_bone_chain_offsets[parent_index + 1] - m_bone_chain_offsets[parent_index]);
+				m_bone_chain_offsets[bone_index + 1] = m_bone_chain_offsets[bone_index] + parent_chain_length + 1;
+			}
+
+			m_bone_chains = allocate_type_array<uint16_t>(allocator, m_bone_chain_offsets[num_bones]);
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			{
+				uint16_t* bone_chain = m_bone_chains + m_bone_chain_offsets[bone_index];
+				const uint32_t chain_length = m_bone_chain_offsets[bone_index + 1] - m_bone_chain_offsets[bone_index];
+
+				const uint16_t parent_index = m_bones[bone_index].parent_index;
+				if (parent_index != INVALID_BONE_INDEX)
+					std::copy(m_bone_chains + m_bone_chain_offsets[parent_index], m_bone_chains + m_bone_chain_offsets[parent_index + 1], bone_chain);
+
+				bone_chain[chain_length - 1] = bone_index;
+			}
 		}
 
 		~RigidSkeleton()
 		{
+			deallocate_type_array(m_allocator, m_bone_chains, m_bone_chain_offsets[m_num_bones]);
+			deallocate_type_array(m_allocator, m_bone_chain_offsets, size_t(m_num_bones) + 1);
 			deallocate_type_array(m_allocator, m_bones, m_num_bones);
 		}
 
@@ -130,10 +157,28 @@ namespace acl
 		}
 		uint16_t get_num_bones() const { return m_num_bones; }
 
+		// Returns the bone indices from the root down to and including the provided bone
+		const uint16_t* get_bone_chain(uint16_t bone_index) const
+		{
+			ACL_ENSURE(bone_index < m_num_bones, "Invalid bone index: %u >= %u", bone_index, m_num_bones);
+			return m_bone_chains + m_bone_chain_offsets[bone_index];
+		}
+
+		// Returns the number of bones in the chain of the provided bone, including itself
+		uint16_t get_bone_chain_length(uint16_t bone_index) const
+		{
+			ACL_ENSURE(bone_index < m_num_bones, "Invalid bone index: %u >= %u", bone_index, m_num_bones);
+			return uint16_t(m_bone_chain_offsets[bone_index + 1] - m_bone_chain_offsets[bone_index]);
+		}
+
 	private:
 		Allocator&	m_allocator;
 		RigidBone*	m_bones;
 
+		// Root first bone chains of every bone stored back to back
+		uint32_t*	m_bone_chain_offsets;
+		uint16_t*	m_bone_chains;
+
 		uint16_t	m_num_bones;
 	};
 
@@ -87,63 +87,56 @@ namespace acl
 		return error;
 	}
 
-	inline float calculate_local_bone_error(const RigidSkeleton& skeleton, const Transform_32* raw_local_pose, const Transform_32* lossy_local_pose, uint16_t bone_index)
+	// Measures the error of a bone with its virtual vertices, both transforms must be in the same space
+	inline float calculate_bone_error(const RigidSkeleton& skeleton, const Transform_32& raw_transform, const Transform_32& lossy_transform, uint16_t bone_index)
 	{
-		uint16_t num_bones = skeleton.get_num_bones();
-		ACL_ENSURE(num_bones != 0, "Invalid number of bones: %u", num_bones);
-		ACL_ENSURE(bone_index < num_bones, "Invalid bone index: %u", bone_index);
-
 		const RigidBone& bone = skeleton.get_bone(bone_index);
 		float vtx_distance = float(bone.vertex_distance);
 
 		Vector4_32 vtx0 = vector_set(vtx_distance, 0.0f, 0.0f);
 		Vector4_32 vtx1 = vector_set(0.0f, vtx_distance, 0.0f);
 
-		Vector4_32 raw_vtx0 = transform_position(raw_local_pose[bone_index], vtx0);
-		Vector4_32 lossy_vtx0 = transform_position(lossy_local_pose[bone_index], vtx0);
+		Vector4_32 raw_vtx0 = transform_position(raw_transform, vtx0);
+		Vector4_32 lossy_vtx0 = transform_position(lossy_transform, vtx0);
 		float vtx0_error = vector_distance3(raw_vtx0, lossy_vtx0);
 
-		Vector4_32 raw_vtx1 = transform_position(raw_local_pose[bone_index], vtx1);
-		Vector4_32 lossy_vtx1 = transform_position(lossy_local_pose[bone_index], vtx1);
+		Vector4_32 raw_vtx1 = transform_position(raw_transform, vtx1);
+		Vector4_32 lossy_vtx1 = transform_position(lossy_transform, vtx1);
 		float vtx1_error = vector_distance3(raw_vtx1, lossy_vtx1);
 
 		return max(vtx0_error, vtx1_error);
 	}
 
-	inline float calculate_object_bone_error(const RigidSkeleton& skeleton, const Transform_32* raw_local_pose, const Transform_32* lossy_local_pose, uint16_t bone_index)
+	inline float calculate_local_bone_error(const RigidSkeleton& skeleton, const Transform_32* raw_local_pose, const Transform_32* lossy_local_pose, uint16_t bone_index)
 	{
 		uint16_t num_bones = skeleton.get_num_bones();
 		ACL_ENSURE(num_bones != 0, "Invalid number of bones: %u", num_bones);
 		ACL_ENSURE(bone_index < num_bones, "Invalid bone index: %u", bone_index);
 
-		const RigidBone& target_bone = skeleton.get_bone(bone_index);
-		float vtx_distance = float(target_bone.vertex_distance);
-
-		std::function<Transform_32(const Transform_32*, uint16_t)> apply_fun;
-		apply_fun = [&](const Transform_32* local_pose, uint16_t bone_index) -> Transform_32
-		{
-			if (bone_index == 0)
-				return local_pose[0];
-			const RigidBone& bone = skeleton.get_bone(bone_index);
-			Transform_32 parent_transform = apply_fun(local_pose, bone.parent_index);
-			return transform_mul(local_pose[bone_index], parent_transform);
-		};
+		return calculate_bone_error(skeleton, raw_local_pose[bone_index], lossy_local_pose[bone_index], bone_index);
+	}
 
-		Transform_32 raw_obj_transform = apply_fun(raw_local_pose, bone_index);
-		Transform_32 lossy_obj_transform = apply_fun(lossy_local_pose, bone_index);
+	inline float calculate_object_bone_error(const RigidSkeleton& skeleton, const Transform_32* raw_local_pose, const Transform_32* lossy_local_pose, uint16_t bone_index)
+	{
+		uint16_t num_bones = skeleton.get_num_bones();
+		ACL_ENSURE(num_bones != 0, "Invalid number of bones: %u", num_bones);
+		ACL_ENSURE(bone_index < num_bones, "Invalid bone index: %u", bone_index);
 
-		Vector4_32 vtx0 = vector_set(vtx_distance, 0.0f, 0.0f);
-		Vector4_32 vtx1 = vector_set(0.0f, vtx_distance, 0.0f);
+		// Walk the chain from the root down to our bone, the root being the first bone
+		const uint16_t* bone_chain = skeleton.get_bone_chain(bone_index);
+		const uint16_t num_bones_in_chain = skeleton.get_bone_chain_length(bone_index);
 
-		Vector4_32 raw_vtx0 = transform_position(raw_obj_transform, vtx0);
-		Vector4_32 raw_vtx1 = transform_position(raw_obj_transform, vtx1);
-		Vector4_32 lossy_vtx0 = transform_position(lossy_obj_transform, vtx0);
-		Vector4_32 lossy_vtx1 = transform_position(lossy_obj_transform, vtx1);
+		Transform_32 raw_obj_transform = raw_local_pose[0];
+		Transform_32 lossy_obj_transform = lossy_local_pose[0];
 
-		float vtx0_error = vector_distance3(raw_vtx0, lossy_vtx0);
-		float vtx1_error = vector_distance3(raw_vtx1, lossy_vtx1);
+		for (uint16_t chain_link_index = 1; chain_link_index < num_bones_in_chain; ++chain_link_index)
+		{
+			const uint16_t chain_bone_index = bone_chain[chain_link_index];
+			raw_obj_transform = transform_mul(raw_local_pose[chain_bone_index], raw_obj_transform);
+			lossy_obj_transform = transform_mul(lossy_local_pose[chain_bone_index], lossy_obj_transform);
+		}
 
-		return max(vtx0_error, vtx1_error);
+		return calculate_bone_error(skeleton, raw_obj_transform, lossy_obj_transform, bone_index);
 	}
 
 	struct BoneError
@@ -127,6 +127,7 @@ namespace acl
 		segment.animated_data_size = 0;
 		segment.range_data_size = 0;
 		segment.segment_index = 0;
+		segment.lossy_sample_cache_peak_size = 0;
 		segment.are_rotations_normalized = false;
 		segment.are_translations_normalized = false;
 	}
@@ -35,6 +35,8 @@
 #include "acl/compression/skeleton_error_metric.h"
 
 #include <stdint.h>
+#include <atomic>
+#include <thread>
 
 // 0 = no debug info, 1 = basic info, 2 = verbose
 #define ACL_DEBUG_VARIABLE_QUANTIZATION		0
@@ -308,6 +310,34 @@ namespace acl
 			}
 		}
 
+		// Object space transforms of a bone sampled so far by the bit rate search.
+		// Samples are always evaluated in order, a bone only ever holds its first few samples.
+		struct BoneObjectTransforms
+		{
+			BoneObjectTransforms()
+				: raw_transforms(nullptr)
+				, lossy_transforms(nullptr)
+				, num_raw_samples(0)
+				, num_lossy_samples(0)
+				, lossy_bit_rate{ INVALID_BIT_RATE, INVALID_BIT_RATE }
+				, generation(0)
+				, parent_generation(0)
+			{}
+
+			// Allocated the first time the bone is sampled, the lossy transforms follow the raw transforms
+			Transform_32* raw_transforms;
+			Transform_32* lossy_transforms;
+
+			uint32_t num_raw_samples;
+			uint32_t num_lossy_samples;
+
+			// The lossy transforms hold for this bit rate and the lossy transforms of this generation of our parent.
+			// Our generation changes every time we discard our lossy transforms, which discards those of our children.
+			BoneBitRate lossy_bit_rate;
+			uint32_t generation;
+			uint32_t parent_generation;
+		};
+
 		struct QuantizationContext
 		{
 			Allocator& allocator;
@@ -330,13 +360,28 @@ namespace acl
 			Transform_32* lossy_local_pose;
 			BoneBitRate* bit_rate_per_bone;
 
-			QuantizationContext(Allocator& allocator_, SegmentContext& segment, RotationFormat8 rotation_format_, VectorFormat8 translation_format_, const AnimationClip& clip_, const RigidSkeleton& skeleton_)
+			// Number of threads the bone bit rate search can use
+			uint16_t num_threads;
+
+			// Lossy samples decoded so far by the bit rate search, never shared between threads
+			QuantizedSampleCache lossy_sample_cache;
+
+			// Bytes used by the lossy sample caches of the worker copies during the local space search
+			size_t worker_lossy_sample_cache_size;
+
+			// Object space transforms sampled so far by the bit rate search, never shared between threads
+			BoneObjectTransforms* object_transforms;
+
+			QuantizationContext(Allocator& allocator_, SegmentContext& segment, RotationFormat8 rotation_format_, VectorFormat8 translation_format_, const AnimationClip& clip_, const RigidSkeleton& skeleton_, uint16_t num_threads_ = 1)
 				: allocator(allocator_)
 				, bone_streams(segment.bone_streams)
 				, num_bones(segment.num_bones)
 				, rotation_format(rotation_format_)
 				, translation_format(translation_format_)
 				, skeleton(skeleton_)
+				, num_threads(num_threads_)
+				, lossy_sample_cache(allocator_, segment.num_bones, segment.num_samples)
+				, worker_lossy_sample_cache_size(0)
 			{
 				num_samples = segment.num_samples;
 				segment_sample_start_index = segment.clip_sample_offset;
@@ -348,22 +393,122 @@ namespace acl
 				raw_local_pose = allocate_type_array<Transform_32>(allocator, num_bones);
 				lossy_local_pose = allocate_type_array<Transform_32>(allocator, num_bones);
 				bit_rate_per_bone = allocate_type_array<BoneBitRate>(allocator, num_bones);
+				object_transforms = allocate_type_array<BoneObjectTransforms>(allocator, num_bones);
+			}
+
+			// A copy samples the same streams but owns its scratch poses, bit rates and caches, one per worker thread
+			QuantizationContext(const QuantizationContext& other)
+				: allocator(other.allocator)
+				, bone_streams(other.bone_streams)
+				, num_bones(other.num_bones)
+				, rotation_format(other.rotation_format)
+				, translation_format(other.translation_format)
+				, skeleton(other.skeleton)
+				, num_samples(other.num_samples)
+				, segment_sample_start_index(other.segment_sample_start_index)
+				, sample_rate(other.sample_rate)
+				, error_threshold(other.error_threshold)
+				, clip_duration(other.clip_duration)
+				, segment_duration(other.segment_duration)
+				, raw_bone_streams(other.raw_bone_streams)
+				, num_threads(1)
+				, lossy_sample_cache(other.allocator, other.num_bones, other.num_samples)
+				, worker_lossy_sample_cache_size(0)
+			{
+				raw_local_pose = allocate_type_array<Transform_32>(allocator, num_bones);
+				lossy_local_pose = allocate_type_array<Transform_32>(allocator, num_bones);
+				bit_rate_per_bone = allocate_type_array<BoneBitRate>(allocator, num_bones);
+				memcpy(bit_rate_per_bone, other.bit_rate_per_bone, sizeof(BoneBitRate) * num_bones);
+				object_transforms = allocate_type_array<BoneObjectTransforms>(allocator, num_bones);
 			}
 
+			QuantizationContext& operator=(const QuantizationContext&) = delete;
+
 			~QuantizationContext()
 			{
 				deallocate_type_array(allocator, raw_local_pose, num_bones);
 				deallocate_type_array(allocator, lossy_local_pose, num_bones);
 				deallocate_type_array(allocator, bit_rate_per_bone, num_bones);
+
+				for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+					deallocate_type_array(allocator, object_transforms[bone_index].raw_transforms, size_t(num_samples) * 2);
+				deallocate_type_array(allocator, object_transforms, num_bones);
 			}
 		};
 
+		// Discards the lossy object space transforms of the bones in a chain that were sampled with different bit rates or
+		// from different parent transforms. Walking the chain from the root down, a bone that changes forces its children to follow.
+		inline void validate_object_transforms(QuantizationContext& context, const uint16_t* bone_chain, uint16_t num_bones_in_chain)
+		{
+			uint32_t parent_generation = 0;
+
+			for (uint16_t chain_link_index = 0; chain_link_index < num_bones_in_chain; ++chain_link_index)
+			{
+				const uint16_t bone_index = bone_chain[chain_link_index];
+				const BoneBitRate& bone_bit_rate = context.bit_rate_per_bone[bone_index];
+				BoneObjectTransforms& transforms = context.object_transforms[bone_index];
+
+				const bool is_bit_rate_stale = transforms.lossy_bit_rate.rotation != bone_bit_rate.rotation || transforms.lossy_bit_rate.translation != bone_bit_rate.translation;
+				if (is_bit_rate_stale || transforms.parent_generation != parent_generation)
+				{
+					transforms.num_lossy_samples = 0;
+					transforms.lossy_bit_rate = bone_bit_rate;
+					transforms.parent_generation = parent_generation;
+					transforms.generation++;
+				}
+
+				parent_generation = transforms.generation;
+			}
+		}
+
+		// Samples the object space transforms of every bone in a chain, only the bones that do not hold the sample yet are sampled
+		inline void sample_object_transforms(QuantizationContext& context, const BoneStreams* ref_bone_streams, const uint16_t* bone_chain, uint16_t num_bones_in_chain, uint32_t sample_index, float sample_time, float ref_sample_time)
+		{
+			const BoneObjectTransforms* parent_transforms = nullptr;
+
+			for (uint16_t chain_link_index = 0; chain_link_index < num_bones_in_chain; ++chain_link_index)
+			{
+				const uint16_t bone_index = bone_chain[chain_link_index];
+				BoneObjectTransforms& transforms = context.object_transforms[bone_index];
+
+				if (transforms.raw_transforms == nullptr)
+				{
+					transforms.raw_transforms = allocate_type_array<Transform_32>(context.allocator, size_t(context.num_samples) * 2);
+					transforms.lossy_transforms = transforms.raw_transforms + context.num_samples;
+				}
+
+				ACL_ASSERT(transforms.num_raw_samples >= sample_index && transforms.num_lossy_samples >= sample_index, "Samples must be evaluated in order");
+
+				if (transforms.num_raw_samples == sample_index)
+				{
+					const Transform_32 raw_local_transform = sample_bone_stream(ref_bone_streams[bone_index], ref_sample_time);
+					transforms.raw_transforms[sample_index] = parent_transforms == nullptr ? raw_local_transform : transform_mul(raw_local_transform, parent_transforms->raw_transforms[sample_index]);
+					transforms.num_raw_samples++;
+				}
+
+				if (transforms.num_lossy_samples == sample_index)
+				{
+					const Transform_32 lossy_local_transform = sample_bone_stream(context.bone_streams[bone_index], sample_time, context.bit_rate_per_bone[bone_index], context.rotation_format, context.translation_format, &context.lossy_sample_cache);
+					transforms.lossy_transforms[sample_index] = parent_transforms == nullptr ? lossy_local_transform : transform_mul(lossy_local_transform, parent_transforms->lossy_transforms[sample_index]);
+					transforms.num_lossy_samples++;
+				}
+
+				parent_transforms = &transforms;
+			}
+		}
+
 		inline float calculate_max_error_at_bit_rate(QuantizationContext& context, uint16_t target_bone_index, bool use_local_error, bool scan_whole_clip = false)
 		{
 			float max_error = 0.0f;
 			constexpr bool use_raw_streams = true;
 			float ref_duration = use_raw_streams ? float(get_animated_num_samples(context.raw_bone_streams, context.num_bones) - 1) / context.sample_rate : context.clip_duration;
 
+			// Only the parts of the chain whose bit rates changed since the last evaluation are sampled again
+			const uint16_t* bone_chain = context.skeleton.get_bone_chain(target_bone_index);
+			const uint16_t num_bones_in_chain = context.skeleton.get_bone_chain_length(target_bone_index);
+			if (!use_local_error)
+				validate_object_transforms(context, bone_chain, num_bones_in_chain);
+
 			for (uint32_t sample_index = 0; sample_index < context.num_samples; ++sample_index)
 			{
 				// Sample our streams and calculate the error
@@ -372,15 +517,23 @@ namespace acl
 
 				const BoneStreams* ref_bone_streams = use_raw_streams ? context.raw_bone_streams : context.bone_streams;
 
-				sample_streams_hierarchical(ref_bone_streams, context.num_bones, ref_sample_time, target_bone_index, context.raw_local_pose);
-				sample_streams_hierarchical(context.bone_streams, context.num_bones, sample_time, target_bone_index, context.bit_rate_per_bone, context.rotation_format, context.translation_format, context.lossy_local_pose);
-
 				// Constant branch
 				float error;
 				if (use_local_error)
+				{
+					// The local space error only depends on the target bone
+					context.raw_local_pose[target_bone_index] = sample_bone_stream(ref_bone_streams[target_bone_index], ref_sample_time);
+					context.lossy_local_pose[target_bone_index] = sample_bone_stream(context.bone_streams[target_bone_index], sample_time, context.bit_rate_per_bone[target_bone_index], context.rotation_format, context.translation_format, &context.lossy_sample_cache);
+
 					error = calculate_local_bone_error(context.skeleton, context.raw_local_pose, context.lossy_local_pose, target_bone_index);
+				}
 				else
-					error = calculate_object_bone_error(context.skeleton, context.raw_local_pose, context.lossy_local_pose, target_bone_index);
+				{
+					sample_object_transforms(context, ref_bone_streams, bone_chain, num_bones_in_chain, sample_index, sample_time, ref_sample_time);
+
+					const BoneObjectTransforms& target_transforms = context.object_transforms[target_bone_index];
+					error = calculate_bone_error(context.skeleton, target_transforms.raw_transforms[sample_index], target_transforms.lossy_transforms[sample_index], target_bone_index);
+				}
 
 				max_error = max(max_error, error);
 				if (!scan_whole_clip && error >= context.error_threshold)
@@ -390,7 +543,9 @@ namespace acl
 			return max_error;
 		}
 
-		inline void calculate_local_space_bit_rates(QuantizationContext& context)
+		// Finds the lowest bit rates of a bone that meet the error threshold in local space.
+		// The local space error only depends on the bit rates of the bone, other bones can hold any bit rate.
+		inline BoneBitRate calculate_local_space_bit_rate(QuantizationContext& context, uint16_t bone_index)
 		{
 			// Here is how an exhaustive search to minimize the total bit rate works out for a single bone with 2 tracks
 			// rot + 1 trans + 0 ( 3), rot + 0 trans + 1 ( 3)
@@ -404,26 +559,73 @@ namespace acl
 			// rot + 3 trans + 5 (24), rot + 4 trans + 4 (24), rot + 5 trans + 3 (24)
 			// rot + 4 trans + 5 (27), rot + 5 trans + 4 (27)
 			// rot + 5 trans + 5 (30)
-			for (uint16_t bone_index = 0; bone_index < context.num_bones; ++bone_index)
+			const BoneBitRate bone_bit_rates = context.bit_rate_per_bone[bone_index];
+
+			if (bone_bit_rates.rotation == INVALID_BIT_RATE && bone_bit_rates.translation == INVALID_BIT_RATE)
 			{
-				const BoneBitRate bone_bit_rates = context.bit_rate_per_bone[bone_index];
+#if ACL_DEBUG_VARIABLE_QUANTIZATION
+				printf("%u: Best bit rates: %u | %u\n", bone_index, bone_bit_rates.rotation, bone_bit_rates.translation);
+#endif
+				return bone_bit_rates;
+			}
+
+			BoneBitRate best_bit_rates = BoneBitRate{ std::max<uint8_t>(bone_bit_rates.rotation, HIGHEST_BIT_RATE), std::max<uint8_t>(bone_bit_rates.translation, HIGHEST_BIT_RATE) };
+			uint8_t best_size = 0xFF;
+			float best_error = context.error_threshold;
+
+			uint8_t num_iterations = NUM_BIT_RATES - 1;
+			for (uint8_t iteration = 1; iteration <= num_iterations; ++iteration)
+			{
+				uint8_t target_sum = 3 * iteration;
 
-				if (bone_bit_rates.rotation == INVALID_BIT_RATE && bone_bit_rates.translation == INVALID_BIT_RATE)
+				for (uint8_t rotation_bit_rate = bone_bit_rates.rotation; rotation_bit_rate < NUM_BIT_RATES || rotation_bit_rate >= HIGHEST_BIT_RATE; ++rotation_bit_rate)
 				{
-#if ACL_DEBUG_VARIABLE_QUANTIZATION
-					printf("%u: Best bit rates: %u | %u\n", bone_index, bone_bit_rates.rotation, bone_bit_rates.translation);
+					for (uint8_t translation_bit_rate = bone_bit_rates.translation; translation_bit_rate < NUM_BIT_RATES || translation_bit_rate >= HIGHEST_BIT_RATE; ++translation_bit_rate)
+					{
+						uint8_t rotation_increment = rotation_bit_rate - bone_bit_rates.rotation;
+						uint8_t translation_increment = translation_bit_rate - bone_bit_rates.translation;
+						uint8_t current_sum = rotation_increment * 3 + translation_increment * 3;
+						if (current_sum != target_sum)
+						{
+							if (translation_bit_rate >= HIGHEST_BIT_RATE)
+								break;
+							else
+								continue;
+						}
+
+						context.bit_rate_per_bone[bone_index] = BoneBitRate{ rotation_bit_rate, translation_bit_rate };
+						float error = calculate_max_error_at_bit_rate(context, bone_index, true);
+
+#if ACL_DEBUG_VARIABLE_QUANTIZATION > 1
+						printf("%u: %u | %u (%u) = %f\n", bone_index, rotation_bit_rate, translation_bit_rate, target_sum, error);
 #endif
-					continue;
+
+						if (error < best_error && target_sum <= best_size)
+						{
+							best_size = target_sum;
+							best_error = error;
+							best_bit_rates = context.bit_rate_per_bone[bone_index];
+						}
+
+						context.bit_rate_per_bone[bone_index] = bone_bit_rates;
+
+						if (translation_bit_rate >= HIGHEST_BIT_RATE)
+							break;
+					}
+
+					if (rotation_bit_rate >= HIGHEST_BIT_RATE)
+						break;
 				}
 
-				BoneBitRate best_bit_rates = BoneBitRate{ std::max<uint8_t>(bone_bit_rates.rotation, HIGHEST_BIT_RATE), std::max<uint8_t>(bone_bit_rates.translation, HIGHEST_BIT_RATE) };
-				uint8_t best_size = 0xFF;
-				float best_error = context.error_threshold;
+				if (best_size != 0xFF)
+					break;
+			}
 
-				uint8_t num_iterations = NUM_BIT_RATES - 1;
+			if (best_size == 0xFF)
+			{
 				for (uint8_t iteration = 1; iteration <= num_iterations; ++iteration)
 				{
-					uint8_t target_sum = 3 * iteration;
+					uint8_t target_sum = 3 * iteration + (3 * num_iterations);
 
 					for (uint8_t rotation_bit_rate = bone_bit_rates.rotation; rotation_bit_rate < NUM_BIT_RATES || rotation_bit_rate >= HIGHEST_BIT_RATE; ++rotation_bit_rate)
 					{
@@ -467,62 +669,56 @@ namespace acl
 					if (best_size != 0xFF)
 						break;
 				}
+			}
 
-				if (best_size == 0xFF)
-				{
-					for (uint8_t iteration = 1; iteration <= num_iterations; ++iteration)
-					{
-						uint8_t target_sum = 3 * iteration + (3 * num_iterations);
+#if ACL_DEBUG_VARIABLE_QUANTIZATION
+			printf("%u: Best bit rates: %u | %u (%u) = %f\n", bone_index, best_bit_rates.rotation, best_bit_rates.translation, best_size, best_error);
+#endif
+			return best_bit_rates;
+		}
 
-						for (uint8_t rotation_bit_rate = bone_bit_rates.rotation; rotation_bit_rate < NUM_BIT_RATES || rotation_bit_rate >= HIGHEST_BIT_RATE; ++rotation_bit_rate)
-						{
-							for (uint8_t translation_bit_rate = bone_bit_rates.translation; translation_bit_rate < NUM_BIT_RATES || translation_bit_rate >= HIGHEST_BIT_RATE; ++translation_bit_rate)
-							{
-								uint8_t rotation_increment = rotation_bit_rate - bone_bit_rates.rotation;
-								uint8_t translation_increment = translation_bit_rate - bone_bit_rates.translation;
-								uint8_t current_sum = rotation_increment * 3 + translation_increment * 3;
-								if (current_sum != target_sum)
-								{
-									if (translation_bit_rate >= HIGHEST_BIT_RATE)
-										break;
-									else
-										continue;
-								}
-
-								context.bit_rate_per_bone[bone_index] = BoneBitRate{ rotation_bit_rate, translation_bit_rate };
-								float error = calculate_max_error_at_bit_rate(context, bone_index, true);
+		inline void calculate_local_space_bit_rates(QuantizationContext& context)
+		{
+			const uint16_t num_workers = std::min<uint16_t>(context.num_threads, context.num_bones);
+			if (num_workers <= 1)
+			{
+				for (uint16_t bone_index = 0; bone_index < context.num_bones; ++bone_index)
+					context.bit_rate_per_bone[bone_index] = calculate_local_space_bit_rate(context, bone_index);
+				return;
+			}
 
-#if ACL_DEBUG_VARIABLE_QUANTIZATION > 1
-								printf("%u: %u | %u (%u) = %f\n", bone_index, rotation_bit_rate, translation_bit_rate, target_sum, error);
-#endif
+			// Every worker searches with its own copy of the context, the best bit rates are only committed once
+			// every bone is done. Since the search of a bone ignores the other bones, the result is identical
+			// to searching serially.
+			BoneBitRate* best_bit_rates = allocate_type_array<BoneBitRate>(context.allocator, context.num_bones);
 
-								if (error < best_error && target_sum <= best_size)
-								{
-									best_size = target_sum;
-									best_error = error;
-									best_bit_rates = context.bit_rate_per_bone[bone_index];
-								}
+			std::atomic<uint32_t> next_bone_index(0);
+			std::atomic<size_t> worker_cache_size(0);
+			auto worker = [&]()
+			{
+				QuantizationContext worker_context(context);
+				for (uint32_t bone_index = next_bone_index++; bone_index < context.num_bones; bone_index = next_bone_index++)
+					best_bit_rates[bone_index] = calculate_local_space_bit_rate(worker_context, uint16_t(bone_index));
 
-								context.bit_rate_per_bone[bone_index] = bone_bit_rates;
+				worker_cache_size += worker_context.lossy_sample_cache.get_size();
+			};
 
-								if (translation_bit_rate >= HIGHEST_BIT_RATE)
-									break;
-							}
+			const uint16_t num_extra_threads = num_workers - 1;
+			std::thread* threads = allocate_type_array<std::thread>(context.allocator, num_extra_threads);
+			for (uint16_t thread_index = 0; thread_index < num_extra_threads; ++thread_index)
+				threads[thread_index] = std::thread(worker);
 
-							if (rotation_bit_rate >= HIGHEST_BIT_RATE)
-								break;
-						}
+			worker();
 
-						if (best_size != 0xFF)
-							break;
-					}
-				}
+			for (uint16_t thread_index = 0; thread_index < num_extra_threads; ++thread_index)
+				threads[thread_index].join();
 
-#if ACL_DEBUG_VARIABLE_QUANTIZATION
-				printf("%u: Best bit rates: %u | %u (%u) = %f\n", bone_index, best_bit_rates.rotation, best_bit_rates.translation, best_size, best_error);
-#endif
-				context.bit_rate_per_bone[bone_index] = best_bit_rates;
-			}
+			deallocate_type_array(context.allocator, threads, num_extra_threads);
+
+			context.worker_lossy_sample_cache_size = worker_cache_size;
+
+			memcpy(context.bit_rate_per_bone, best_bit_rates, sizeof(BoneBitRate) * context.num_bones);
+			deallocate_type_array(context.allocator, best_bit_rates, context.num_bones);
 		}
 
 		inline uint8_t increment_and_clamp_bit_rate(uint8_t bit_rate, uint8_t increment)
@@ -621,7 +817,7 @@ namespace acl
 			return best_error;
 		}
 
-		inline void quantize_variable_streams_new(Allocator& allocator, SegmentContext& segment, RotationFormat8 rotation_format, VectorFormat8 translation_format, const AnimationClip& clip, const RigidSkeleton& skeleton, const BoneStreams* raw_bone_streams)
+		inline void quantize_variable_streams_new(Allocator& allocator, SegmentContext& segment, RotationFormat8 rotation_format, VectorFormat8 translation_format, const AnimationClip& clip, const RigidSkeleton& skeleton, const BoneStreams* raw_bone_streams, uint16_t num_threads = 1)
 		{
 			// Duplicate our streams
 			BoneStreams* quantized_streams = allocate_type_array<BoneStreams>(allocator, segment.num_bones);
@@ -645,7 +841,7 @@ namespace acl
 			else
 				quantize_fixed_translation_streams(allocator, quantized_streams, segment.num_bones, translation_format);
 
-			QuantizationContext context(allocator, segment, rotation_format, translation_format, clip, skeleton);
+			QuantizationContext context(allocator, segment, rotation_format, translation_format, clip, skeleton, num_threads);
 			context.raw_bone_streams = raw_bone_streams;
 
 			for (uint16_t bone_index = 0; bone_index < segment.num_bones; ++bone_index)
@@ -946,6 +1142,9 @@ namespace acl
 				std::swap(segment.bone_streams[bone_index], quantized_streams[bone_index]);
 			}
 
+			// The worker copies are released before the chain search starts, the cache of our context only grows
+			segment.lossy_sample_cache_peak_size = uint32_t(std::max(context.worker_lossy_sample_cache_size, context.lossy_sample_cache.get_size()));
+
 			deallocate_type_array(allocator, bone_chain_permutation, segment.num_bones);
 			deallocate_type_array(allocator, chain_bone_indices, segment.num_bones);
 			deallocate_type_array(allocator, permutation_bit_rates, segment.num_bones);
@@ -1195,14 +1394,23 @@ namespace acl
 		}
 	}
 
-	inline void quantize_streams(Allocator& allocator, ClipContext& clip_context, RotationFormat8 rotation_format, VectorFormat8 translation_format, const AnimationClip& clip, const RigidSkeleton& skeleton, const ClipContext& raw_clip_context)
+	// Segments are independent once the clip and segment ranges are known, they can be quantized concurrently.
+	// Every segment uses its own quantization context and scratch buffers, the output is identical regardless of
+	// the number of threads. Threads left over once every segment has a worker search the bit rates of
+	// the bones of a segment concurrently. The allocator must be thread safe when more than one thread is used.
+	inline void quantize_streams(Allocator& allocator, ClipContext& clip_context, RotationFormat8 rotation_format, VectorFormat8 translation_format, const AnimationClip& clip, const RigidSkeleton& skeleton, const ClipContext& raw_clip_context, uint16_t num_threads = 1)
 	{
 		const bool is_rotation_variable = is_rotation_format_variable(rotation_format);
 		const bool is_translation_variable = is_vector_format_variable(translation_format);
 		constexpr bool use_new_variable_quantization = true;
 		const BoneStreams* raw_bone_streams = raw_clip_context.segments[0].bone_streams;
 
-		for (SegmentContext& segment : clip_context.segment_iterator())
+		// Fixed formats are cheap to quantize, only the variable bit rate search benefits from more threads
+		const bool is_variable = is_rotation_variable || is_translation_variable;
+		const uint16_t num_workers = is_variable ? std::max<uint16_t>(std::min<uint16_t>(num_threads, clip_context.num_segments), 1) : 1;
+		const uint16_t num_threads_per_segment = is_variable ? std::max<uint16_t>(num_threads / num_workers, 1) : 1;
+
+		auto quantize_segment = [&](SegmentContext& segment)
 		{
 #if ACL_DEBUG_VARIABLE_QUANTIZATION
 			printf("Quantizing segment %u...\n", segment.segment_index);
@@ -1211,7 +1419,7 @@ namespace acl
 			if (is_rotation_variable || is_translation_variable)
 			{
 				if (use_new_variable_quantization)
-					impl::quantize_variable_streams_new(allocator, segment, rotation_format, translation_format, clip, skeleton, raw_bone_streams);
+					impl::quantize_variable_streams_new(allocator, segment, rotation_format, translation_format, clip, skeleton, raw_bone_streams, num_threads_per_segment);
 				else
 					impl::quantize_variable_streams(allocator, segment.bone_streams, segment.num_bones, rotation_format, translation_format, clip, skeleton);
 			}
@@ -1223,6 +1431,33 @@ namespace acl
 				if (!is_translation_variable)
 					impl::quantize_fixed_translation_streams(allocator, segment.bone_streams, segment.num_bones, translation_format);
 			}
+		};
+
+		if (num_workers <= 1)
+		{
+			for (SegmentContext& segment : clip_context.segment_iterator())
+				quantize_segment(segment);
+			return;
 		}
+
+		// Workers pick the next segment as they become idle, the calling thread is one of them
+		std::atomic<uint32_t> next_segment_index(0);
+		auto worker = [&]()
+		{
+			for (uint32_t segment_index = next_segment_index++; segment_index < clip_context.num_segments; segment_index = next_segment_index++)
+				quantize_segment(clip_context.segments[segment_index]);
+		};
+
+		const uint16_t num_extra_threads = num_workers - 1;
+		std::thread* threads = allocate_type_array<std::thread>(allocator, num_extra_threads);
+		for (uint16_t thread_index = 0; thread_index < num_extra_threads; ++thread_index)
+			threads[thread_index] = std::thread(worker);
+
+		worker();
+
+		for (uint16_t thread_index = 0; thread_index < num_extra_threads; ++thread_index)
+			threads[thread_index].join();
+
+		deallocate_type_array(allocator, threads, num_extra_threads);
 	}
 }
@@ -27,6 +27,7 @@
 #include "acl/core/memory.h"
 #include "acl/core/error.h"
 #include "acl/core/utils.h"
+#include "acl/core/bitset.h"
 #include "acl/math/quat_32.h"
 #include "acl/math/quat_packing.h"
 #include "acl/math/vector4_32.h"
@@ -35,6 +36,7 @@
 #include "acl/compression/stream/track_stream.h"
 
 #include <stdint.h>
+#include <algorithm>
 
 namespace acl
 {
@@ -550,6 +552,114 @@ namespace acl
 		return packed_translation;
 	}
 
+	// Memoizes the lossy samples of a segment while we search for its bit rates.
+	// The search samples the same keys at the same bit rates over and over, each one
+	// is packed and unpacked the first time it is requested and read back afterwards.
+	// Rows of samples are only allocated for the bit rates a track ends up trying.
+	class QuantizedSampleCache
+	{
+	public:
+		QuantizedSampleCache(Allocator& allocator, uint16_t num_bones, uint32_t num_samples)
+			: m_allocator(allocator)
+			, m_num_rows(uint32_t(num_bones) * NUM_BIT_RATES)
+			, m_num_samples(num_samples)
+			, m_row_size(sizeof(Vector4_32) * num_samples + sizeof(uint32_t) * get_bitset_size(num_samples))
+			, m_size(0)
+		{
+			m_rotation_rows = allocate_type_array<Quat_32*>(allocator, m_num_rows);
+			m_translation_rows = allocate_type_array<Vector4_32*>(allocator, m_num_rows);
+			m_size = sizeof(void*) * m_num_rows * 2;
+
+			std::fill(m_rotation_rows, m_rotation_rows + m_num_rows, nullptr);
+			std::fill(m_translation_rows, m_translation_rows + m_num_rows, nullptr);
+		}
+
+		~QuantizedSampleCache()
+		{
+			for (uint32_t row_index = 0; row_index < m_num_rows; ++row_index)
+			{
+				if (m_rotation_rows[row_index] != nullptr)
+					m_allocator.deallocate(m_rotation_rows[row_index], m_row_size);
+
+				if (m_translation_rows[row_index] != nullptr)
+					m_allocator.deallocate(m_translation_rows[row_index], m_row_size);
+			}
+
+			deallocate_type_array(m_allocator, m_rotation_rows, m_num_rows);
+			deallocate_type_array(m_allocator, m_translation_rows, m_num_rows);
+		}
+
+		QuantizedSampleCache(const QuantizedSampleCache&) = delete;
+		QuantizedSampleCache& operator=(const QuantizedSampleCache&) = delete;
+
+		Quat_32 get_rotation_sample(const BoneStreams& bone_stream, uint32_t sample_index, uint8_t bit_rate)
+		{
+			if (bit_rate >= NUM_BIT_RATES)
+				return acl::get_rotation_sample(bone_stream, sample_index, bit_rate);
+
+			ACL_ENSURE(sample_index < m_num_samples, "Invalid sample index. %u >= %u", sample_index, m_num_samples);
+
+			Quat_32*& samples = m_rotation_rows[uint32_t(bone_stream.bone_index) * NUM_BIT_RATES + bit_rate];
+			if (samples == nullptr)
+				samples = reinterpret_cast<Quat_32*>(allocate_row());
+
+			uint32_t* cached_samples = reinterpret_cast<uint32_t*>(samples + m_num_samples);
+			const uint32_t bitset_size = get_bitset_size(m_num_samples);
+			if (!bitset_test(cached_samples, bitset_size, sample_index))
+			{
+				samples[sample_index] = acl::get_rotation_sample(bone_stream, sample_index, bit_rate);
+				bitset_set(cached_samples, bitset_size, sample_index, true);
+			}
+
+			return samples[sample_index];
+		}
+
+		Vector4_32 get_translation_sample(const BoneStreams& bone_stream, uint32_t sample_index, uint8_t bit_rate)
+		{
+			if (bit_rate >= NUM_BIT_RATES)
+				return acl::get_translation_sample(bone_stream, sample_index, bit_rate);
+
+			ACL_ENSURE(sample_index < m_num_samples, "Invalid sample index. %u >= %u", sample_index, m_num_samples);
+
+			Vector4_32*& samples = m_translation_rows[uint32_t(bone_stream.bone_index) * NUM_BIT_RATES + bit_rate];
+			if (samples == nullptr)
+				samples = reinterpret_cast<Vector4_32*>(allocate_row());
+
+			uint32_t* cached_samples = reinterpret_cast<uint32_t*>(samples + m_num_samples);
+			const uint32_t bitset_size = get_bitset_size(m_num_samples);
+			if (!bitset_test(cached_samples, bitset_size, sample_index))
+			{
+				samples[sample_index] = acl::get_translation_sample(bone_stream, sample_index, bit_rate);
+				bitset_set(cached_samples, bitset_size, sample_index, true);
+			}
+
+			return samples[sample_index];
+		}
+
+		// Returns the number of bytes currently allocated by the cache
+		size_t get_size() const { return m_size; }
+
+	private:
+		void* allocate_row()
+		{
+			uint8_t* row = reinterpret_cast<uint8_t*>(m_allocator.allocate(m_row_size, 16));
+			bitset_reset(reinterpret_cast<uint32_t*>(row + sizeof(Vector4_32) * m_num_samples), get_bitset_size(m_num_samples), false);
+			m_size += m_row_size;
+			return row;
+		}
+
+		Allocator& m_allocator;
+
+		// One row per bone and bit rate: the samples followed by a bitset of which ones are cached
+		Quat_32** m_rotation_rows;
+		Vector4_32** m_translation_rows;
+
+		uint32_t m_num_rows;
+		uint32_t m_num_samples;
+		size_t m_row_size;
+		size_t m_size;
+	};
+
 	inline void sample_streams(const BoneStreams* bone_streams, uint16_t num_bones, float sample_time, Transform_32* out_local_pose)
 	{
 		for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
@@ -600,54 +710,59 @@ namespace acl
 		}
 	}
 
-	inline void sample_streams_hierarchical(const BoneStreams* bone_streams, uint16_t num_bones, float sample_time, uint16_t bone_index, Transform_32* out_local_pose)
+	inline Transform_32 sample_bone_stream(const BoneStreams& bone_stream, float sample_time)
 	{
-		uint16_t current_bone_index = bone_index;
-		while (current_bone_index != INVALID_BONE_INDEX)
+		Quat_32 rotation;
+		if (bone_stream.is_rotation_animated())
 		{
-			const BoneStreams& bone_stream = bone_streams[current_bone_index];
+			uint32_t num_samples = bone_stream.rotations.get_num_samples();
+			float duration = bone_stream.rotations.get_duration();
 
-			Quat_32 rotation;
-			if (bone_stream.is_rotation_animated())
-			{
-				uint32_t num_samples = bone_stream.rotations.get_num_samples();
-				float duration = bone_stream.rotations.get_duration();
+			uint32_t key0;
+			uint32_t key1;
+			float interpolation_alpha;
+			calculate_interpolation_keys(num_samples, duration, sample_time, key0, key1, interpolation_alpha);
 
-				uint32_t key0;
-				uint32_t key1;
-				float interpolation_alpha;
-				calculate_interpolation_keys(num_samples, duration, sample_time, key0, key1, interpolation_alpha);
+			Quat_32 sample0 = get_rotation_sample(bone_stream, key0);
+			Quat_32 sample1 = get_rotation_sample(bone_stream, key1);
+			rotation = quat_lerp(sample0, sample1, interpolation_alpha);
+		}
+		else
+		{
+			rotation = get_rotation_sample(bone_stream, 0);
+		}
 
-				Quat_32 sample0 = get_rotation_sample(bone_stream, key0);
-				Quat_32 sample1 = get_rotation_sample(bone_stream, key1);
-				rotation = quat_lerp(sample0, sample1, interpolation_alpha);
-			}
-			else
-			{
-				rotation = get_rotation_sample(bone_stream, 0);
-			}
+		Vector4_32 translation;
+		if (bone_stream.is_translation_animated())
+		{
+			uint32_t num_samples = bone_stream.translations.get_num_samples();
+			float duration = bone_stream.translations.get_duration();
 
-			Vector4_32 translation;
-			if (bone_stream.is_translation_animated())
-			{
-				uint32_t num_samples = bone_stream.translations.get_num_samples();
-				float duration = bone_stream.translations.get_duration();
+			uint32_t key0;
+			uint32_t key1;
+			float interpolation_alpha;
+			calculate_interpolation_keys(num_samples, duration, sample_time, key0, key1, interpolation_alpha);
 
-				uint32_t key0;
-				uint32_t key1;
-				float interpolation_alpha;
-				calculate_interpolation_keys(num_samples, duration, sample_time, key0, key1, interpolation_alpha);
+			Vector4_32 sample0 = get_translation_sample(bone_stream, key0);
+			Vector4_32 sample1 = get_translation_sample(bone_stream, key1);
+			translation = vector_lerp(sample0, sample1, interpolation_alpha);
+		}
+		else
+		{
+			translation = get_translation_sample(bone_stream, 0);
+		}
 
-				Vector4_32 sample0 = get_translation_sample(bone_stream, key0);
-				Vector4_32 sample1 = get_translation_sample(bone_stream, key1);
-				translation = vector_lerp(sample0, sample1, interpolation_alpha);
-			}
-			else
-			{
-				translation = get_translation_sample(bone_stream, 0);
-			}
+		return transform_set(rotation, translation);
+	}
 
-			out_local_pose[current_bone_index] = transform_set(rotation, translation);
+	inline void sample_streams_hierarchical(const BoneStreams* bone_streams, uint16_t num_bones, float sample_time, uint16_t bone_index, Transform_32* out_local_pose)
+	{
+		uint16_t current_bone_index = bone_index;
+		while (current_bone_index != INVALID_BONE_INDEX)
+		{
+			const BoneStreams& bone_stream = bone_streams[current_bone_index];
+
+			out_local_pose[current_bone_index] = sample_bone_stream(bone_stream, sample_time);
 			current_bone_index = bone_stream.parent_bone_index;
 		}
 	}
@@ -734,86 +849,91 @@ namespace acl
 		}
 	}
 
-	inline void sample_streams_hierarchical(const BoneStreams* bone_streams, uint16_t num_bones, float sample_time, uint16_t bone_index, const BoneBitRate* bit_rates, RotationFormat8 rotation_format, VectorFormat8 translation_format, Transform_32* out_local_pose)
+	inline Transform_32 sample_bone_stream(const BoneStreams& bone_stream, float sample_time, const BoneBitRate& bone_bit_rate, RotationFormat8 rotation_format, VectorFormat8 translation_format, QuantizedSampleCache* sample_cache = nullptr)
 	{
 		const bool is_rotation_variable = is_rotation_format_variable(rotation_format);
 		const bool is_translation_variable = is_vector_format_variable(translation_format);
 
-		uint16_t current_bone_index = bone_index;
-		while (current_bone_index != INVALID_BONE_INDEX)
+		Quat_32 rotation;
+		if (bone_stream.is_rotation_animated())
 		{
-			const BoneStreams& bone_stream = bone_streams[current_bone_index];
+			uint32_t num_samples = bone_stream.rotations.get_num_samples();
+			float duration = bone_stream.rotations.get_duration();
 
-			Quat_32 rotation;
-			if (bone_stream.is_rotation_animated())
-			{
-				uint32_t num_samples = bone_stream.rotations.get_num_samples();
-				float duration = bone_stream.rotations.get_duration();
+			uint32_t key0;
+			uint32_t key1;
+			float interpolation_alpha;
+			calculate_interpolation_keys(num_samples, duration, sample_time, key0, key1, interpolation_alpha);
 
-				uint32_t key0;
-				uint32_t key1;
-				float interpolation_alpha;
-				calculate_interpolation_keys(num_samples, duration, sample_time, key0, key1, interpolation_alpha);
-
-				Quat_32 sample0;
-				Quat_32 sample1;
-				if (is_rotation_variable)
-				{
-					uint8_t bit_rate = bit_rates[current_bone_index].rotation;
-
-					sample0 = get_rotation_sample(bone_stream, key0, bit_rate);
-					sample1 = get_rotation_sample(bone_stream, key1, bit_rate);
-				}
-				else
-				{
-					sample0 = get_rotation_sample(bone_stream, key0, rotation_format);
-					sample1 = get_rotation_sample(bone_stream, key1, rotation_format);
-				}
+			Quat_32 sample0;
+			Quat_32 sample1;
+			if (is_rotation_variable)
+			{
+				uint8_t bit_rate = bone_bit_rate.rotation;
 
-				rotation = quat_lerp(sample0, sample1, interpolation_alpha);
+				sample0 = sample_cache != nullptr ? sample_cache->get_rotation_sample(bone_stream, key0, bit_rate) : get_rotation_sample(bone_stream, key0, bit_rate);
+				sample1 = sample_cache != nullptr ? sample_cache->get_rotation_sample(bone_stream, key1, bit_rate) : get_rotation_sample(bone_stream, key1, bit_rate);
 			}
 			else
 			{
-				if (is_rotation_variable)
-					rotation = get_rotation_sample(bone_stream, 0);
-				else
-					rotation = get_rotation_sample(bone_stream, 0, rotation_format);
+				sample0 = get_rotation_sample(bone_stream, key0, rotation_format);
+				sample1 = get_rotation_sample(bone_stream, key1, rotation_format);
 			}
 
-			Vector4_32 translation;
-			if (bone_stream.is_translation_animated())
-			{
-				uint32_t num_samples = bone_stream.translations.get_num_samples();
-				float duration = bone_stream.translations.get_duration();
+			rotation = quat_lerp(sample0, sample1, interpolation_alpha);
+		}
+		else
+		{
+			if (is_rotation_variable)
+				rotation = get_rotation_sample(bone_stream, 0);
+			else
+				rotation = get_rotation_sample(bone_stream, 0, rotation_format);
+		}
 
-				uint32_t key0;
-				uint32_t key1;
-				float interpolation_alpha;
-				calculate_interpolation_keys(num_samples, duration, sample_time, key0, key1, interpolation_alpha);
+		Vector4_32 translation;
+		if (bone_stream.is_translation_animated())
+		{
+			uint32_t num_samples = bone_stream.translations.get_num_samples();
+			float duration = bone_stream.translations.get_duration();
 
-				Vector4_32 sample0;
-				Vector4_32 sample1;
-				if (is_translation_variable)
-				{
-					uint8_t bit_rate = bit_rates[current_bone_index].translation;
+			uint32_t key0;
+			uint32_t key1;
+			float interpolation_alpha;
+			calculate_interpolation_keys(num_samples, duration, sample_time, key0, key1, interpolation_alpha);
 
-					sample0 = get_translation_sample(bone_stream, key0, bit_rate);
-					sample1 = get_translation_sample(bone_stream, key1, bit_rate);
-				}
-				else
-				{
-					sample0 = get_translation_sample(bone_stream, key0, translation_format);
-					sample1 = get_translation_sample(bone_stream, key1, translation_format);
-				}
+			Vector4_32 sample0;
+			Vector4_32 sample1;
+			if (is_translation_variable)
+			{
+				uint8_t bit_rate = bone_bit_rate.translation;
 
-				translation = vector_lerp(sample0, sample1, interpolation_alpha);
+				sample0 = sample_cache != nullptr ? sample_cache->get_translation_sample(bone_stream, key0, bit_rate) : get_translation_sample(bone_stream, key0, bit_rate);
+				sample1 = sample_cache != nullptr ? sample_cache->get_translation_sample(bone_stream, key1, bit_rate) : get_translation_sample(bone_stream, key1, bit_rate);
 			}
 			else
 			{
-				translation = get_translation_sample(bone_stream, 0, VectorFormat8::Vector3_96);
+				sample0 = get_translation_sample(bone_stream, key0, translation_format);
+				sample1 = get_translation_sample(bone_stream, key1, translation_format);
 			}
 
-			out_local_pose[current_bone_index] = transform_set(rotation, translation);
+			translation = vector_lerp(sample0, sample1, interpolation_alpha);
+		}
+		else
+		{
+			translation = get_translation_sample(bone_stream, 0, VectorFormat8::Vector3_96);
+		}
+
+		return transform_set(rotation, translation);
+	}
+
+	inline void sample_streams_hierarchical(const BoneStreams* bone_streams, uint16_t num_bones, float sample_time, uint16_t bone_index, const BoneBitRate* bit_rates, RotationFormat8 rotation_format, VectorFormat8 translation_format, Transform_32* out_local_pose, QuantizedSampleCache* sample_cache = nullptr)
+	{
+		uint16_t current_bone_index = bone_index;
+		while (current_bone_index != INVALID_BONE_INDEX)
+		{
+			const BoneStreams& bone_stream = bone_streams[current_bone_index];
+
+			out_local_pose[current_bone_index] = sample_bone_stream(bone_stream, sample_time, bit_rates[current_bone_index], rotation_format, translation_format, sample_cache);
 			current_bone_index = bone_stream.parent_bone_index;
 		}
 	}
@@ -74,6 +74,9 @@ namespace acl
 		uint32_t range_data_size;
 		uint32_t segment_index;
 
+		// Largest number of bytes the lossy sample caches used while searching for the variable bit rates
+		uint32_t lossy_sample_cache_peak_size;
+
 		bool are_rotations_normalized;
 		bool are_translations_normalized;
 
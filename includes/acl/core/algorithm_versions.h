@@ -31,7 +31,7 @@
 namespace acl
 {
 	// Algorithm version numbers
-	static constexpr uint16_t ALGORITHM_VERSION_UNIFORMLY_SAMPLED		= 0;
+	static constexpr uint16_t ALGORITHM_VERSION_UNIFORMLY_SAMPLED		= 2;
 	//static constexpr uint16_t ALGORITHM_VERSION_LINEAR_KEY_REDUCTION	= 0;
 	//static constexpr uint16_t ALGORITHM_VERSION_SPLINE_KEY_REDUCTION	= 0;
 
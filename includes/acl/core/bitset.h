@@ -22,7 +22,7 @@ namespace acl
 		ACL_ENSURE(bit_offset < (size * 32), "Invalid bit offset: %u > %u", bit_offset, size * 32);
 
 		uint32_t offset = bit_offset / 32;
-		uint32_t mask = 1 << (31 - (bit_offset - offset));
+		uint32_t mask = 1 << (31 - (bit_offset % 32));
 
 		if (value)
 			bitset[offset] |= mask;
@@ -35,23 +35,32 @@ namespace acl
 		ACL_ENSURE(bit_offset < (size * 32), "Invalid bit offset: %u > %u", bit_offset, size * 32);
 
 		uint32_t offset = bit_offset / 32;
-		uint32_t mask = 1 << (31 - (bit_offset - offset));
+		uint32_t mask = 1 << (31 - (bit_offset % 32));
 
 		return (bitset[offset] & mask) != 0;
 	}
 
-	inline uint32_t bitset_count_set_bits(const uint32_t* bitset, uint32_t size)
+	inline uint32_t count_set_bits(uint32_t value)
 	{
 		// TODO: Use popcount instruction if available
+		value = value - ((value >> 1) & 0x55555555);
+		value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+		return (((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+	}
+
+	inline uint32_t bitset_count_set_bits(const uint32_t* bitset, uint32_t size)
+	{
 		uint32_t num_set_bits = 0;
 		for (uint32_t offset = 0; offset < size; ++offset)
-		{
-			uint32_t value = bitset[offset];
-			value = value - ((value >> 1) & 0x55555555);
-			value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
-			num_set_bits += (((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
-		}
+			num_set_bits += count_set_bits(bitset[offset]);
 
 		return num_set_bits;
 	}
+
+	// Returns a mask of the bits that precede the provided bit offset within the bitset word that contains it.
+	// Bits are stored from the most significant bit to the least significant bit in every word.
+	constexpr uint32_t bitset_leading_bits_mask(uint32_t bit_offset)
+	{
+		return ~(0xFFFFFFFF >> (bit_offset % 32));
+	}
 }
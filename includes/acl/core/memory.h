@@ -33,13 +33,51 @@
 #include <memory>
 #include <algorithm>
 
+#if defined(_M_IX86) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+// Most x86 and ARM processors have 64 byte cache lines, platforms with a different size can define it beforehand
+#if !defined(ACL_CACHE_LINE_SIZE)
+	#if defined(__APPLE__) && defined(__aarch64__)
+		#define ACL_CACHE_LINE_SIZE 128
+	#else
+		#define ACL_CACHE_LINE_SIZE 64
+	#endif
+#endif
+
 namespace acl
 {
+	constexpr size_t CACHE_LINE_SIZE = ACL_CACHE_LINE_SIZE;
+
+	// Hints the processor to load the cache line holding the provided address
+	inline void memory_prefetch(const void* ptr)
+	{
+#if defined(_M_IX86) || defined(_M_X64)
+		_mm_prefetch(reinterpret_cast<const char*>(ptr), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(ptr);
+#else
+		(void)ptr;
+#endif
+	}
+
+	// Hints the processor to load every cache line of the provided memory range.
+	// The range rarely starts on a cache line boundary, we start from the line holding its first byte.
+	inline void memory_prefetch(const void* ptr, size_t size)
+	{
+		const uintptr_t end_address = reinterpret_cast<uintptr_t>(ptr) + size;
+		for (uintptr_t address = reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t(CACHE_LINE_SIZE - 1); address < end_address; address += CACHE_LINE_SIZE)
+			memory_prefetch(reinterpret_cast<const void*>(address));
+	}
+
 	constexpr bool is_power_of_two(size_t input)
 	{
 		return input != 0 && (input & (input - 1)) == 0;
 	}
 
+	static_assert(is_power_of_two(CACHE_LINE_SIZE), "The cache line size must be a power of two");
+
 	template<typename Type>
 	constexpr bool is_alignment_valid(size_t alignment)
 	{
@@ -0,0 +1,82 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Nicholas Frechette & Animation Compression Library contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "acl/core/error.h"
+#include "acl/decompression/output_writer.h"
+#include "acl/math/quat_32.h"
+#include "acl/math/vector4_32.h"
+#include "acl/math/transform_32.h"
+
+#include <stdint.h>
+
+namespace acl
+{
+	// Applies the decompressed pose of an additive clip onto a base pose, in place.
+	// Rotations are composed in local space and translations are added, both scaled by the weight.
+	// Default tracks have no effect on the base pose, the decoder skips them entirely.
+	struct AdditiveOutputWriter : public OutputWriter
+	{
+		AdditiveOutputWriter(Transform_32* base_transforms, uint16_t num_transforms, float weight)
+			: m_base_transforms(base_transforms)
+			, m_weight(weight)
+			, m_num_transforms(num_transforms)
+		{
+			ACL_ENSURE(base_transforms != nullptr, "Base transforms array cannot be null");
+			ACL_ENSURE(num_transforms != 0, "Base transforms array cannot be empty");
+			ACL_ENSURE(weight >= 0.0f && weight <= 1.0f, "Invalid additive weight: %f", weight);
+		}
+
+		constexpr bool skip_default_bone_tracks() const { return true; }
+
+		void write_bone_rotation(uint32_t bone_index, const Quat_32& rotation)
+		{
+			ACL_ENSURE(bone_index < m_num_transforms, "Invalid bone index. %u >= %u", bone_index, m_num_transforms);
+
+			// A zero weight leaves the base pose untouched, unlike composing with the identity which renormalizes it
+			if (m_weight == 0.0f)
+				return;
+
+			const Quat_32 additive_rotation = m_weight == 1.0f ? rotation : quat_lerp(quat_identity_32(), rotation, m_weight);
+			Transform_32& base_transform = m_base_transforms[bone_index];
+			base_transform.rotation = quat_normalize(quat_mul(additive_rotation, base_transform.rotation));
+		}
+
+		void write_bone_translation(uint32_t bone_index, const Vector4_32& translation)
+		{
+			ACL_ENSURE(bone_index < m_num_transforms, "Invalid bone index. %u >= %u", bone_index, m_num_transforms);
+
+			if (m_weight == 0.0f)
+				return;
+
+			Transform_32& base_transform = m_base_transforms[bone_index];
+			base_transform.translation = vector_add(base_transform.translation, vector_mul(translation, m_weight));
+		}
+
+		Transform_32* m_base_transforms;
+		float m_weight;
+		uint16_t m_num_transforms;
+	};
+}
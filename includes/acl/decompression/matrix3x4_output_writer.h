@@ -0,0 +1,170 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Nicholas Frechette & Animation Compression Library contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "acl/core/error.h"
+#include "acl/core/memory.h"
+#include "acl/decompression/object_space_output_writer.h"
+#include "acl/decompression/output_writer.h"
+#include "acl/math/math.h"
+#include "acl/math/quat_32.h"
+#include "acl/math/vector4_32.h"
+#include "acl/math/transform_32.h"
+
+#include <stdint.h>
+
+namespace acl
+{
+	// Scalar version of matrix3x4_from_rotation_translation(..), always available to validate the SIMD version against
+	inline void matrix3x4_from_rotation_translation_scalar(const Quat_32& rotation, const Vector4_32& translation, Vector4_32& out_row0, Vector4_32& out_row1, Vector4_32& out_row2)
+	{
+		const float x = quat_get_x(rotation);
+		const float y = quat_get_y(rotation);
+		const float z = quat_get_z(rotation);
+		const float w = quat_get_w(rotation);
+
+		const float x2 = x + x;
+		const float y2 = y + y;
+		const float z2 = z + z;
+
+		const float xx = x * x2;
+		const float xy = x * y2;
+		const float xz = x * z2;
+		const float yy = y * y2;
+		const float yz = y * z2;
+		const float zz = z * z2;
+		const float wx = w * x2;
+		const float wy = w * y2;
+		const float wz = w * z2;
+
+		out_row0 = vector_set(1.0f - (yy + zz), xy - wz, xz + wy, vector_get_x(translation));
+		out_row1 = vector_set(xy + wz, 1.0f - (xx + zz), yz - wx, vector_get_y(translation));
+		out_row2 = vector_set(xz - wy, yz + wx, 1.0f - (xx + yy), vector_get_z(translation));
+	}
+
+	// Converts a rotation and a translation into the 3 rows of a row-major 3x4 matrix that transforms column vectors.
+	// The translation lives in the W component of every row.
+	inline void matrix3x4_from_rotation_translation(const Quat_32& rotation, const Vector4_32& translation, Vector4_32& out_row0, Vector4_32& out_row1, Vector4_32& out_row2)
+	{
+#if defined(ACL_SSE2_INTRINSICS)
+		const __m128 q = rotation;
+		const __m128 q2 = _mm_add_ps(q, q);
+
+		// Diagonal: [1 - 2(yy + zz), 1 - 2(xx + zz), 1 - 2(xx + yy)]
+		const __m128 squares = _mm_mul_ps(q, q2);
+		const __m128 diagonal_lhs = _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(3, 0, 0, 1));
+		const __m128 diagonal_rhs = _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(3, 1, 2, 2));
+		const __m128 diagonal = _mm_sub_ps(_mm_sub_ps(_mm_set_ps1(1.0f), diagonal_lhs), diagonal_rhs);
+
+		// Off diagonal: [2xz, 2xy, 2yz] +- [2wy, 2wz, 2wx]
+		const __m128 products = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 1, 0, 0)), _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(3, 2, 1, 2)));
+		const __m128 w_products = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(3, 0, 2, 1)));
+		const __m128 sums = _mm_add_ps(products, w_products);
+		const __m128 differences = _mm_sub_ps(products, w_products);
+
+		// Row 0: [diagonal.x, differences.y, sums.x, translation.x]
+		__m128 lhs = _mm_shuffle_ps(diagonal, differences, _MM_SHUFFLE(1, 1, 0, 0));
+		__m128 rhs = _mm_shuffle_ps(sums, translation, _MM_SHUFFLE(0, 0, 0, 0));
+		out_row0 = _mm_shuffle_ps(lhs, rhs, _MM_SHUFFLE(2, 0, 2, 0));
+
+		// Row 1: [sums.y, diagonal.y, differences.z, translation.y]
+		lhs = _mm_shuffle_ps(sums, diagonal, _MM_SHUFFLE(1, 1, 1, 1));
+		rhs = _mm_shuffle_ps(differences, translation, _MM_SHUFFLE(1, 1, 2, 2));
+		out_row1 = _mm_shuffle_ps(lhs, rhs, _MM_SHUFFLE(2, 0, 2, 0));
+
+		// Row 2: [differences.x, sums.z, diagonal.z, translation.z]
+		lhs = _mm_shuffle_ps(differences, sums, _MM_SHUFFLE(2, 2, 0, 0));
+		rhs = _mm_shuffle_ps(diagonal, translation, _MM_SHUFFLE(2, 2, 2, 2));
+		out_row2 = _mm_shuffle_ps(lhs, rhs, _MM_SHUFFLE(2, 0, 2, 0));
+#else
+		matrix3x4_from_rotation_translation_scalar(rotation, translation, out_row0, out_row1, out_row2);
+#endif
+	}
+
+	// Writes the decompressed pose as row-major 3x4 matrices, 12 floats per bone, ready for skinning.
+	// Bones are first composed in object space with their parent, like ObjectSpaceOutputWriter does, in the
+	// provided object space transforms which hold the object space pose afterwards. Each matrix is then
+	// optionally combined with the inverse bind pose of its bone, also in object space.
+	// With SSE2 the matrices are written with streaming stores that bypass the cache since the
+	// pose is typically consumed by the GPU, the buffer must then be 16 bytes aligned.
+	// The decoder writes the bones in order for this writer, the decode plan is ignored.
+	struct Matrix3x4OutputWriter : public OutputWriter
+	{
+		static constexpr uint32_t NUM_FLOATS_PER_MATRIX = 12;
+
+		Matrix3x4OutputWriter(const uint16_t* parent_indices, Transform_32* object_transforms, float* matrices, uint16_t num_matrices, const Transform_32* inverse_bind_pose = nullptr)
+			: m_object_space_writer(parent_indices, object_transforms, num_matrices)
+			, m_matrices(matrices)
+			, m_inverse_bind_pose(inverse_bind_pose)
+		{
+			ACL_ENSURE(matrices != nullptr, "Matrices array cannot be null");
+			ACL_ENSURE(is_aligned_to(matrices, 16), "Matrices array must be 16 bytes aligned");
+		}
+
+		constexpr bool requires_bone_order() const { return true; }
+
+		~Matrix3x4OutputWriter()
+		{
+#if defined(ACL_SSE2_INTRINSICS)
+			// Make the streamed matrices visible before anyone reads them
+			_mm_sfence();
+#endif
+		}
+
+		void write_bone_rotation(uint32_t bone_index, const Quat_32& rotation)
+		{
+			m_object_space_writer.write_bone_rotation(bone_index, rotation);
+		}
+
+		void write_bone_translation(uint32_t bone_index, const Vector4_32& translation)
+		{
+			m_object_space_writer.write_bone_translation(bone_index, translation);
+
+			Transform_32 skinning_transform = m_object_space_writer.m_transforms[bone_index];
+			if (m_inverse_bind_pose != nullptr)
+				skinning_transform = transform_mul(m_inverse_bind_pose[bone_index], skinning_transform);
+
+			Vector4_32 row0;
+			Vector4_32 row1;
+			Vector4_32 row2;
+			matrix3x4_from_rotation_translation(skinning_transform.rotation, skinning_transform.translation, row0, row1, row2);
+
+			float* matrix = m_matrices + (bone_index * NUM_FLOATS_PER_MATRIX);
+#if defined(ACL_SSE2_INTRINSICS)
+			_mm_stream_ps(matrix + 0, row0);
+			_mm_stream_ps(matrix + 4, row1);
+			_mm_stream_ps(matrix + 8, row2);
+#else
+			vector_unaligned_write(row0, matrix + 0);
+			vector_unaligned_write(row1, matrix + 4);
+			vector_unaligned_write(row2, matrix + 8);
+#endif
+		}
+
+		ObjectSpaceOutputWriter m_object_space_writer;
+		float* m_matrices;
+		const Transform_32* m_inverse_bind_pose;
+	};
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Nicholas Frechette & Animation Compression Library contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "acl/core/error.h"
+#include "acl/decompression/output_writer.h"
+#include "acl/math/quat_32.h"
+#include "acl/math/vector4_32.h"
+#include "acl/math/transform_32.h"
+
+#include <stdint.h>
+
+namespace acl
+{
+	// Writes the decompressed pose in object space instead of local space.
+	// Each bone is combined with its parent as soon as its translation is decompressed, while
+	// the local transform is still in registers, instead of in a second pass over the pose.
+	// Parent indices must precede their children, root bones use INVALID_PARENT_INDEX.
+	// The decoder writes the bones in order for this writer, the decode plan is ignored.
+	struct ObjectSpaceOutputWriter : public OutputWriter
+	{
+		static constexpr uint16_t INVALID_PARENT_INDEX = 0xFFFF;
+
+		ObjectSpaceOutputWriter(const uint16_t* parent_indices, Transform_32* transforms, uint16_t num_transforms)
+			: m_parent_indices(parent_indices)
+			, m_transforms(transforms)
+			, m_local_rotation(quat_identity_32())
+			, m_num_transforms(num_transforms)
+			, m_rotation_bone_index(INVALID_PARENT_INDEX)
+		{
+			ACL_ENSURE(parent_indices != nullptr, "Parent indices array cannot be null");
+			ACL_ENSURE(transforms != nullptr, "Transforms array cannot be null");
+			ACL_ENSURE(num_transforms != 0, "Transforms array cannot be empty");
+		}
+
+		constexpr bool requires_bone_order() const { return true; }
+
+		void write_bone_rotation(uint32_t bone_index, const Quat_32& rotation)
+		{
+			ACL_ENSURE(bone_index < m_num_transforms, "Invalid bone index. %u >= %u", bone_index, m_num_transforms);
+			m_local_rotation = rotation;
+			m_rotation_bone_index = uint16_t(bone_index);
+		}
+
+		void write_bone_translation(uint32_t bone_index, const Vector4_32& translation)
+		{
+			ACL_ENSURE(bone_index == m_rotation_bone_index, "The rotation of bone %u must be written before its translation", bone_index);
+
+			const Transform_32 local_transform = transform_set(m_local_rotation, translation);
+
+			const uint16_t parent_bone_index = m_parent_indices[bone_index];
+			if (parent_bone_index == INVALID_PARENT_INDEX)
+			{
+				m_transforms[bone_index] = local_transform;
+				return;
+			}
+
+			ACL_ENSURE(parent_bone_index < bone_index, "Bones must be sorted parent first");
+
+			Transform_32 object_transform = transform_mul(local_transform, m_transforms[parent_bone_index]);
+
+			// The product of two normalized rotations only drifts slightly, normalize only once it matters
+			if (!quat_is_normalized(object_transform.rotation))
+				object_transform.rotation = quat_normalize(object_transform.rotation);
+
+			m_transforms[bone_index] = object_transform;
+		}
+
+		const uint16_t* m_parent_indices;
+		Transform_32* m_transforms;
+		Quat_32 m_local_rotation;
+		uint16_t m_num_transforms;
+		uint16_t m_rotation_bone_index;
+	};
+}
@@ -36,7 +36,26 @@ namespace acl
 	// the callbacks can trivially be inlined.
 	struct OutputWriter
 	{
-		// TODO: use constexpr flags to control if we extract rotation only, translation only, etc.
+		// Override these in a derived writer to skip the decompression of every rotation or translation track.
+		// Skipped tracks are never written, the decoder only steps over their data.
+		// Like skip_default_bone_tracks(), they must be the same for every instance of a writer type,
+		// batched decompression only queries the first writer.
+		constexpr bool skip_all_bone_rotations() const { return false; }
+		constexpr bool skip_all_bone_translations() const { return false; }
+
+		// Override this in a derived writer when writing a default track has no effect, e.g. when
+		// composing an additive pose. Default rotations are the identity and default translations are zero.
+		// The decoder then skips default tracks when it can, they might still be written.
+		constexpr bool skip_default_bone_tracks() const { return false; }
+
+		// Override this in a derived writer when the output already holds the value of every constant and
+		// default track, e.g. written by a previous decompression of the same clip. Unlike the other flags,
+		// it can change between decompressions. The decoder then skips invariant tracks when it can.
+		constexpr bool skip_constant_bone_tracks() const { return false; }
+
+		// Override this in a derived writer that requires the bones to be written in order, parent first,
+		// with the rotation of each bone before its translation. The decoder then never uses a decode plan.
+		constexpr bool requires_bone_order() const { return false; }
 
 		void write_bone_rotation(uint32_t bone_index, const Quat_32& rotation)
 		{
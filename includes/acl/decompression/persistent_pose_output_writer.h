@@ -0,0 +1,66 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Nicholas Frechette & Animation Compression Library contributors
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "acl/core/compressed_clip.h"
+#include "acl/decompression/default_output_writer.h"
+#include "acl/math/math_types.h"
+
+#include <stdint.h>
+
+namespace acl
+{
+	// Writes into a pose that persists between decompressions, e.g. the pose of a long-lived instance.
+	// Constant and default tracks hold the same value on every frame, they are only written by the
+	// first decompression of a clip and afterwards only the animated tracks are written.
+	// begin_pose(..) must be called before every decompression and the first decompression of a clip
+	// must write the whole pose, partial poses would leave the other invariant tracks unwritten.
+	struct PersistentPoseOutputWriter : public DefaultOutputWriter
+	{
+		PersistentPoseOutputWriter(Transform_32* transforms, uint16_t num_transforms)
+			: DefaultOutputWriter(transforms, num_transforms)
+			, m_clip(nullptr)
+			, m_has_invariant_tracks(false)
+		{}
+
+		void begin_pose(const CompressedClip& clip)
+		{
+			m_has_invariant_tracks = m_clip == &clip;
+			m_clip = &clip;
+		}
+
+		// Writes every track on the next decompression, when the pose was modified by something else
+		void reset()
+		{
+			m_clip = nullptr;
+			m_has_invariant_tracks = false;
+		}
+
+		bool skip_constant_bone_tracks() const { return m_has_invariant_tracks; }
+
+		const CompressedClip* m_clip;
+		bool m_has_invariant_tracks;
+	};
+}
@@ -291,16 +291,39 @@ namespace acl
 		*data = vector_u64;
 	}
 
+	// Normalizes the three quantized components of a vector, all at once when SIMD is available
+	inline Vector4_32 unpack_vector3_n_components(uint64_t x64, uint64_t y64, uint64_t z64, uint8_t XBits, uint8_t YBits, uint8_t ZBits, bool is_unsigned)
+	{
+#if defined(ACL_SSE2_INTRINSICS)
+		ACL_ENSURE(x64 < (uint64_t(1) << XBits) && y64 < (uint64_t(1) << YBits) && z64 < (uint64_t(1) << ZBits), "Invalid input values: %llu, %llu, %llu", x64, y64, z64);
+
+		// Components have at most 19 bits and convert to float exactly, the division matches the scalar path
+		__m128i value_u32 = _mm_set_epi32(0, int32_t(z64), int32_t(y64), int32_t(x64));
+		__m128i max_value_u32 = _mm_set_epi32(1, (1 << ZBits) - 1, (1 << YBits) - 1, (1 << XBits) - 1);
+		__m128 value = _mm_div_ps(_mm_cvtepi32_ps(value_u32), _mm_cvtepi32_ps(max_value_u32));
+
+		if (!is_unsigned)
+		{
+			value = _mm_sub_ps(_mm_mul_ps(value, _mm_set_ps1(2.0f)), _mm_set_ps1(1.0f));
+			value = _mm_and_ps(value, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+		}
+
+		return value;
+#else
+		float x = is_unsigned ? unpack_scalar_unsigned(x64, XBits) : unpack_scalar_signed(x64, XBits);
+		float y = is_unsigned ? unpack_scalar_unsigned(y64, YBits) : unpack_scalar_signed(y64, YBits);
+		float z = is_unsigned ? unpack_scalar_unsigned(z64, ZBits) : unpack_scalar_signed(z64, ZBits);
+		return vector_set(x, y, z);
+#endif
+	}
+
 	inline Vector4_32 unpack_vector3_n(uint8_t XBits, uint8_t YBits, uint8_t ZBits, bool is_unsigned, const uint8_t* vector_data)
 	{
 		uint64_t vector_u64 = *safe_ptr_cast<const uint64_t>(vector_data);
 		uint64_t x64 = vector_u64 >> (YBits + ZBits);
 		uint64_t y64 = (vector_u64 >> ZBits) & ((1 << YBits) - 1);
 		uint64_t z64 = vector_u64 & ((1 << ZBits) - 1);
-		float x = is_unsigned ? unpack_scalar_unsigned(x64, XBits) : unpack_scalar_signed(x64, XBits);
-		float y = is_unsigned ? unpack_scalar_unsigned(y64, YBits) : unpack_scalar_signed(y64, YBits);
-		float z = is_unsigned ? unpack_scalar_unsigned(z64, ZBits) : unpack_scalar_signed(z64, ZBits);
-		return vector_set(x, y, z);
+		return unpack_vector3_n_components(x64, y64, z64, XBits, YBits, ZBits, is_unsigned);
 	}
 
 	// Assumes the 'vector_data' is in big-endian order
@@ -330,10 +353,7 @@ namespace acl
 			z64 = vector_u64;
 		}
 
-		float x = is_unsigned ? unpack_scalar_unsigned(x64, XBits) : unpack_scalar_signed(x64, XBits);
-		float y = is_unsigned ? unpack_scalar_unsigned(y64, YBits) : unpack_scalar_signed(y64, YBits);
-		float z = is_unsigned ? unpack_scalar_unsigned(z64, ZBits) : unpack_scalar_signed(z64, ZBits);
-		return vector_set(x, y, z);
+		return unpack_vector3_n_components(x64, y64, z64, XBits, YBits, ZBits, is_unsigned);
 	}
 
 	//////////////////////////////////////////////////////////////////////////
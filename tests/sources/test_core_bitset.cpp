@@ -0,0 +1,40 @@
+#include <catch.hpp>
+
+#include <acl/core/bitset.h>
+
+using namespace acl;
+
+TEST_CASE("bitset", "[core][bitset]")
+{
+	constexpr uint32_t num_bits = 80;
+	constexpr uint32_t bitset_size = get_bitset_size(num_bits);
+	REQUIRE(bitset_size == 3);
+
+	uint32_t bitset[bitset_size];
+	bitset_reset(bitset, bitset_size, false);
+	REQUIRE(bitset_count_set_bits(bitset, bitset_size) == 0);
+
+	bitset_set(bitset, bitset_size, 0, true);
+	bitset_set(bitset, bitset_size, 33, true);
+	bitset_set(bitset, bitset_size, 79, true);
+	REQUIRE(bitset[0] == 0x80000000);
+	REQUIRE(bitset[1] == 0x40000000);
+	REQUIRE(bitset[2] == 0x00010000);
+	REQUIRE(bitset_count_set_bits(bitset, bitset_size) == 3);
+
+	for (uint32_t bit_offset = 0; bit_offset < num_bits; ++bit_offset)
+		REQUIRE(bitset_test(bitset, bitset_size, bit_offset) == (bit_offset == 0 || bit_offset == 33 || bit_offset == 79));
+
+	bitset_set(bitset, bitset_size, 33, false);
+	REQUIRE(bitset[1] == 0);
+	REQUIRE(bitset_count_set_bits(bitset, bitset_size) == 2);
+
+	REQUIRE(count_set_bits(0) == 0);
+	REQUIRE(count_set_bits(0xFFFFFFFF) == 32);
+	REQUIRE(count_set_bits(0xAAAAAAAA) == 16);
+
+	REQUIRE(bitset_leading_bits_mask(0) == 0);
+	REQUIRE(bitset_leading_bits_mask(1) == 0x80000000);
+	REQUIRE(bitset_leading_bits_mask(33) == 0x80000000);
+	REQUIRE(bitset_leading_bits_mask(31) == 0xFFFFFFFE);
+}
@@ -23,6 +23,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "acl/core/memory.h"
+#include "acl/core/scope_profiler.h"
 #include "acl/core/range_reduction_types.h"
 #include "acl/compression/skeleton.h"
 #include "acl/compression/animation_clip.h"
@@ -31,16 +32,23 @@
 #include "acl/sjson/sjson_writer.h"
 
 #include "acl/algorithm/uniformly_sampled/algorithm.h"
+#include "acl/decompression/object_space_output_writer.h"
+#include "acl/decompression/matrix3x4_output_writer.h"
+#include "acl/decompression/additive_output_writer.h"
+#include "acl/decompression/persistent_pose_output_writer.h"
 
 #include <conio.h>
 
 #include <cstring>
 #include <cstdio>
 #include <fstream>
+#include <functional>
 #include <streambuf>
 #include <sstream>
 #include <string>
 #include <memory>
+#include <thread>
+#include <vector>
 
 using namespace acl;
 
@@ -49,6 +57,7 @@ struct Options
 	const char*		input_filename;
 	bool			output_stats;
 	const char*		output_stats_filename;
+	bool			benchmark;
 
 	//////////////////////////////////////////////////////////////////////////
 
@@ -58,12 +67,14 @@ struct Options
 		: input_filename(nullptr),
 		  output_stats(false)
 		, output_stats_filename(nullptr)
+		, benchmark(false)
 		, output_stats_file(nullptr)
 	{}
 
 	Options(Options&& other)
 		: output_stats(other.output_stats)
 		, output_stats_filename(other.output_stats_filename)
+		, benchmark(other.benchmark)
 		, output_stats_file(other.output_stats_file)
 	{
 		new (&other) Options();
@@ -79,6 +90,7 @@ struct Options
 	{
 		std::swap(output_stats, rhs.output_stats);
 		std::swap(output_stats_filename, rhs.output_stats_filename);
+		std::swap(benchmark, rhs.benchmark);
 		std::swap(output_stats_file, rhs.output_stats_file);
 	}
 
@@ -96,52 +108,1909 @@ struct Options
 
 constexpr char* ACL_INPUT_FILE_OPTION = "-acl=";
 constexpr char* STATS_OUTPUT_OPTION = "-stats";
+constexpr char* BENCHMARK_OPTION = "-bench";
+
+// Number of times we decompress every sample when benchmarking
+constexpr uint32_t NUM_BENCHMARK_ITERATIONS = 10;
 
 static bool parse_options(int argc, char** argv, Options& options)
 {
-	for (int arg_index = 1; arg_index < argc; ++arg_index)
+	for (int arg_index = 1; arg_index < argc; ++arg_index)
+	{
+		const char* argument = argv[arg_index];
+
+		size_t option_length = std::strlen(ACL_INPUT_FILE_OPTION);
+		if (std::strncmp(argument, ACL_INPUT_FILE_OPTION, option_length) == 0)
+		{
+			options.input_filename = argument + option_length;
+			continue;
+		}
+
+		option_length = std::strlen(STATS_OUTPUT_OPTION);
+		if (std::strncmp(argument, STATS_OUTPUT_OPTION, option_length) == 0)
+		{
+			options.output_stats = true;
+			if (argument[option_length] == '=')
+			{
+				options.output_stats_filename = argument + option_length + 1;
+				size_t filename_len = std::strlen(options.output_stats_filename);
+				if (filename_len < 6 || strncmp(options.output_stats_filename + filename_len - 6, ".sjson", 6) != 0)
+				{
+					printf("Stats output file must be an SJSON file.\n");
+					return false;
+				}
+			}
+			else
+				options.output_stats_filename = nullptr;
+
+			options.open_output_stats_file();
+			continue;
+		}
+
+		option_length = std::strlen(BENCHMARK_OPTION);
+		if (std::strncmp(argument, BENCHMARK_OPTION, option_length) == 0)
+		{
+			options.benchmark = true;
+			continue;
+		}
+
+		printf("Unrecognized option %s\n", argument);
+		return false;
+	}
+
+	if (options.input_filename == nullptr || std::strlen(options.input_filename) == 0)
+	{
+		printf("An input file is required.\n");
+		return false;
+	}
+
+	return true;
+}
+
+template<typename SampleFunType>
+static double measure_decompression_time(const AnimationClip& clip, SampleFunType sample_fun)
+{
+	float clip_duration = clip.get_duration();
+	float sample_rate = float(clip.get_sample_rate());
+	uint32_t num_samples = calculate_num_samples(clip_duration, clip.get_sample_rate());
+
+	ScopeProfiler timer;
+	for (uint32_t iteration = 0; iteration < NUM_BENCHMARK_ITERATIONS; ++iteration)
+	{
+		for (uint32_t sample_index = 0; sample_index < num_samples; ++sample_index)
+		{
+			float sample_time = min(float(sample_index) / sample_rate, clip_duration);
+			sample_fun(sample_time);
+		}
+	}
+	timer.stop();
+
+	// Average time in seconds per call
+	return cycles_to_seconds(timer.get_elapsed_cycles()) / double(NUM_BENCHMARK_ITERATIONS * num_samples);
+}
+
+// Reference scalar implementation of unpack_vector3_n, used to measure the SIMD path against
+static Vector4_32 unpack_vector3_n_scalar(uint8_t num_bits, bool is_unsigned, const uint8_t* vector_data, uint64_t bit_offset)
+{
+	uint64_t vector_u64 = byte_swap(*reinterpret_cast<const uint64_t*>(vector_data + (bit_offset / 8)));
+	vector_u64 <<= bit_offset % 8;
+	vector_u64 >>= 64 - (num_bits * 3);
+
+	uint64_t x64 = vector_u64 >> (num_bits * 2);
+	uint64_t y64 = (vector_u64 >> num_bits) & ((1 << num_bits) - 1);
+	uint64_t z64 = vector_u64 & ((1 << num_bits) - 1);
+
+	float x = is_unsigned ? unpack_scalar_unsigned(x64, num_bits) : unpack_scalar_signed(x64, num_bits);
+	float y = is_unsigned ? unpack_scalar_unsigned(y64, num_bits) : unpack_scalar_signed(y64, num_bits);
+	float z = is_unsigned ? unpack_scalar_unsigned(z64, num_bits) : unpack_scalar_signed(z64, num_bits);
+	return vector_set(x, y, z);
+}
+
+static void benchmark_variable_unpacking(SJSONObjectWriter& writer)
+{
+	constexpr uint32_t NUM_PACKED_VECTORS = 4096;
+	constexpr uint32_t NUM_UNPACK_ITERATIONS = 100;
+	constexpr uint8_t NUM_BITS = 16;
+
+	// Enough padding for the last 64 bit load
+	uint8_t packed_data[NUM_PACKED_VECTORS * 6 + 8];
+	for (uint32_t byte_index = 0; byte_index < sizeof(packed_data); ++byte_index)
+		packed_data[byte_index] = uint8_t(byte_index * 37);
+
+	auto measure_unpack_time = [&](auto unpack_fun)
+	{
+		Vector4_32 sum = vector_zero_32();
+
+		ScopeProfiler timer;
+		for (uint32_t iteration = 0; iteration < NUM_UNPACK_ITERATIONS; ++iteration)
+		{
+			for (uint32_t vector_index = 0; vector_index < NUM_PACKED_VECTORS; ++vector_index)
+				sum = vector_add(sum, unpack_fun(packed_data, uint64_t(vector_index) * NUM_BITS * 3));
+		}
+		timer.stop();
+
+		// Keep the result alive so the loop isn't optimized away
+		ACL_ENSURE(vector_is_finite3(sum), "Unpacked vectors are not valid");
+
+		// Average time in seconds per unpacked vector
+		return cycles_to_seconds(timer.get_elapsed_cycles()) / double(NUM_UNPACK_ITERATIONS * NUM_PACKED_VECTORS);
+	};
+
+	writer["num_bits"] = NUM_BITS;
+	writer["scalar_time"] = measure_unpack_time([](const uint8_t* data, uint64_t bit_offset) { return unpack_vector3_n_scalar(NUM_BITS, true, data, bit_offset); });
+	writer["unpack_time"] = measure_unpack_time([](const uint8_t* data, uint64_t bit_offset) { return unpack_vector3_n(NUM_BITS, NUM_BITS, NUM_BITS, true, data, bit_offset); });
+}
+
+struct NearestKeyDecompressionSettings : public uniformly_sampled::DecompressionSettings
+{
+	constexpr uniformly_sampled::SamplingMode8 get_sampling_mode() const { return uniformly_sampled::SamplingMode8::Nearest; }
+};
+
+// Measures how many poses per second a crowd of instances playing the same clip decompresses,
+// one instance at a time with and without interpolation, and as a single batch
+static void benchmark_crowd_decompression(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, SJSONArrayWriter& writer)
+{
+	using namespace uniformly_sampled;
+
+	constexpr uint32_t CROWD_SIZES[] = { 1, 16, 256, 4096 };
+
+	uint16_t num_bones = clip.get_num_bones();
+	float clip_duration = clip.get_duration();
+	float sample_rate = float(clip.get_sample_rate());
+	uint32_t num_samples = calculate_num_samples(clip_duration, clip.get_sample_rate());
+
+	DecompressionSettings settings;
+	NearestKeyDecompressionSettings nearest_key_settings;
+
+	for (uint32_t num_instances : CROWD_SIZES)
+	{
+		std::vector<void*> contexts(num_instances);
+		std::vector<float> sample_times(num_instances);
+		std::vector<DefaultOutputWriter> pose_writers;
+		pose_writers.reserve(num_instances);
+
+		Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, size_t(num_instances) * num_bones);
+
+		for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+		{
+			contexts[instance_index] = allocate_decompression_context(allocator, settings, compressed_clip);
+			pose_writers.emplace_back(lossy_pose_transforms + (size_t(instance_index) * num_bones), num_bones);
+		}
+
+		// Every instance starts at a different sample and all of them advance together
+		auto update_sample_times = [&](uint32_t iteration)
+		{
+			for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+				sample_times[instance_index] = min(float((instance_index + iteration) % num_samples) / sample_rate, clip_duration);
+		};
+
+		ScopeProfiler single_timer;
+		for (uint32_t iteration = 0; iteration < NUM_BENCHMARK_ITERATIONS; ++iteration)
+		{
+			update_sample_times(iteration);
+			for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+				decompress_pose(settings, compressed_clip, contexts[instance_index], sample_times[instance_index], pose_writers[instance_index]);
+		}
+		single_timer.stop();
+
+		ScopeProfiler nearest_key_timer;
+		for (uint32_t iteration = 0; iteration < NUM_BENCHMARK_ITERATIONS; ++iteration)
+		{
+			update_sample_times(iteration);
+			for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+				decompress_pose(nearest_key_settings, compressed_clip, contexts[instance_index], sample_times[instance_index], pose_writers[instance_index]);
+		}
+		nearest_key_timer.stop();
+
+		ScopeProfiler batch_timer;
+		for (uint32_t iteration = 0; iteration < NUM_BENCHMARK_ITERATIONS; ++iteration)
+		{
+			update_sample_times(iteration);
+			decompress_poses(settings, compressed_clip, contexts.data(), sample_times.data(), pose_writers.data(), num_instances);
+		}
+		batch_timer.stop();
+
+		const double num_poses = double(num_instances) * double(NUM_BENCHMARK_ITERATIONS);
+
+		writer.push_object([&](SJSONObjectWriter& writer)
+		{
+			writer["num_instances"] = num_instances;
+			writer["single_poses_per_second"] = num_poses / cycles_to_seconds(single_timer.get_elapsed_cycles());
+			writer["nearest_key_poses_per_second"] = num_poses / cycles_to_seconds(nearest_key_timer.get_elapsed_cycles());
+			writer["batch_poses_per_second"] = num_poses / cycles_to_seconds(batch_timer.get_elapsed_cycles());
+		});
+
+		for (void* context : contexts)
+			deallocate_decompression_context(allocator, context);
+
+		deallocate_type_array(allocator, lossy_pose_transforms, size_t(num_instances) * num_bones);
+	}
+}
+
+// Measures how many poses per second many threads sampling the same clip decompress, when every thread
+// owns an allocated context and when all of them share a single context through a stack cursor per pose
+static void benchmark_multithreaded_decompression(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, SJSONArrayWriter& writer)
+{
+	using namespace uniformly_sampled;
+
+	constexpr uint32_t THREAD_COUNTS[] = { 8, 16, 32 };
+	constexpr uint32_t NUM_POSES_PER_THREAD = 1000;
+
+	uint16_t num_bones = clip.get_num_bones();
+	float clip_duration = clip.get_duration();
+	float sample_rate = float(clip.get_sample_rate());
+	uint32_t num_samples = calculate_num_samples(clip_duration, clip.get_sample_rate());
+
+	DecompressionSettings settings;
+
+	SharedDecompressionContext shared_context;
+	initialize_shared_decompression_context(settings, compressed_clip, shared_context);
+
+	for (uint32_t num_threads : THREAD_COUNTS)
+	{
+		std::vector<void*> contexts(num_threads);
+		std::vector<std::thread> threads;
+		threads.reserve(num_threads);
+
+		// Allocations happen up front, the threads only decompress
+		Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, size_t(num_threads) * num_bones);
+
+		for (uint32_t thread_index = 0; thread_index < num_threads; ++thread_index)
+			contexts[thread_index] = allocate_decompression_context(allocator, settings, compressed_clip);
+
+		auto sample_poses = [&](uint32_t thread_index, bool use_shared_context)
+		{
+			DefaultOutputWriter pose_writer(lossy_pose_transforms + (size_t(thread_index) * num_bones), num_bones);
+
+			for (uint32_t pose_index = 0; pose_index < NUM_POSES_PER_THREAD; ++pose_index)
+			{
+				float sample_time = min(float((thread_index + pose_index) % num_samples) / sample_rate, clip_duration);
+
+				if (use_shared_context)
+				{
+					DecompressionCursor cursor;
+					initialize_decompression_cursor(shared_context, cursor);
+					decompress_pose(settings, compressed_clip, &cursor, sample_time, pose_writer);
+				}
+				else
+					decompress_pose(settings, compressed_clip, contexts[thread_index], sample_time, pose_writer);
+			}
+		};
+
+		auto run_threads = [&](bool use_shared_context)
+		{
+			ScopeProfiler timer;
+			for (uint32_t thread_index = 0; thread_index < num_threads; ++thread_index)
+				threads.emplace_back(sample_poses, thread_index, use_shared_context);
+
+			for (std::thread& thread : threads)
+				thread.join();
+
+			threads.clear();
+			return cycles_to_seconds(timer.stop());
+		};
+
+		const double owned_elapsed_time = run_threads(false);
+		const double shared_elapsed_time = run_threads(true);
+		const double num_poses = double(num_threads) * double(NUM_POSES_PER_THREAD);
+
+		writer.push_object([&](SJSONObjectWriter& writer)
+		{
+			writer["num_threads"] = num_threads;
+			writer["owned_context_poses_per_second"] = num_poses / owned_elapsed_time;
+			writer["shared_context_poses_per_second"] = num_poses / shared_elapsed_time;
+			writer["owned_context_bytes"] = uint32_t(num_threads * get_decompression_context_size(contexts[0]));
+			writer["shared_context_bytes"] = uint32_t(sizeof(SharedDecompressionContext));
+		});
+
+		for (void* context : contexts)
+			deallocate_decompression_context(allocator, context);
+
+		deallocate_type_array(allocator, lossy_pose_transforms, size_t(num_threads) * num_bones);
+	}
+}
+
+struct PlaybackCursorDecompressionSettings : public uniformly_sampled::DecompressionSettings
+{
+	constexpr bool use_playback_cursor() const { return true; }
+};
+
+struct KeyFrameCacheDecompressionSettings : public uniformly_sampled::DecompressionSettings
+{
+	constexpr bool use_key_frame_cache() const { return true; }
+};
+
+// Measures the average time per frame to play back the whole clip at a fixed frame rate
+template<class SettingsType>
+static double measure_playback_time(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, const SettingsType& settings, float frame_rate)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+	float clip_duration = clip.get_duration();
+	uint32_t num_frames = safe_static_cast<uint32_t>(floor(clip_duration * frame_rate)) + 1;
+
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+
+	ScopeProfiler timer;
+	for (uint32_t iteration = 0; iteration < NUM_BENCHMARK_ITERATIONS; ++iteration)
+	{
+		for (uint32_t frame_index = 0; frame_index < num_frames; ++frame_index)
+		{
+			float sample_time = min(float(frame_index) / frame_rate, clip_duration);
+			decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+		}
+	}
+	timer.stop();
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, context);
+
+	return cycles_to_seconds(timer.get_elapsed_cycles()) / double(NUM_BENCHMARK_ITERATIONS * num_frames);
+}
+
+struct PrefetchDecompressionSettings : public uniformly_sampled::DecompressionSettings
+{
+	constexpr bool use_software_prefetching() const { return true; }
+};
+
+// Larger than the last level cache of most processors, touching all of it evicts the clip
+constexpr size_t COLD_CACHE_FLUSH_BUFFER_SIZE = 32 * 1024 * 1024;
+constexpr uint32_t NUM_COLD_CACHE_SAMPLES = 64;
+
+// Measures the average time to decompress a pose when none of the clip data is in the cache
+template<class SettingsType>
+static double measure_cold_decompression_time(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, const SettingsType& settings, uint8_t* flush_buffer)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+	float clip_duration = clip.get_duration();
+
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+
+	uint64_t elapsed_cycles = 0;
+	for (uint32_t sample_index = 0; sample_index < NUM_COLD_CACHE_SAMPLES; ++sample_index)
+	{
+		for (size_t offset = 0; offset < COLD_CACHE_FLUSH_BUFFER_SIZE; offset += CACHE_LINE_SIZE)
+			flush_buffer[offset]++;
+
+		float sample_time = clip_duration * float(sample_index) / float(NUM_COLD_CACHE_SAMPLES - 1);
+
+		ScopeProfiler timer;
+		decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+		elapsed_cycles += timer.stop();
+	}
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, context);
+
+	return cycles_to_seconds(elapsed_cycles) / double(NUM_COLD_CACHE_SAMPLES);
+}
+
+struct RotationOnlyOutputWriter : public DefaultOutputWriter
+{
+	RotationOnlyOutputWriter(Transform_32* transforms, uint16_t num_transforms) : DefaultOutputWriter(transforms, num_transforms) {}
+
+	constexpr bool skip_all_bone_translations() const { return true; }
+};
+
+struct TranslationOnlyOutputWriter : public DefaultOutputWriter
+{
+	TranslationOnlyOutputWriter(Transform_32* transforms, uint16_t num_transforms) : DefaultOutputWriter(transforms, num_transforms) {}
+
+	constexpr bool skip_all_bone_rotations() const { return true; }
+};
+
+struct DecodePlanDecompressionSettings : public uniformly_sampled::DecompressionSettings
+{
+	constexpr bool use_decode_plan() const { return true; }
+};
+
+// Counts the bytes written into the output pose
+template<class WriterType>
+struct ByteCountingOutputWriter : public WriterType
+{
+	ByteCountingOutputWriter(Transform_32* transforms, uint16_t num_transforms) : WriterType(transforms, num_transforms), m_num_bytes_written(0) {}
+
+	void write_bone_rotation(uint32_t bone_index, const Quat_32& rotation)
+	{
+		m_num_bytes_written += sizeof(Quat_32);
+		WriterType::write_bone_rotation(bone_index, rotation);
+	}
+
+	void write_bone_translation(uint32_t bone_index, const Vector4_32& translation)
+	{
+		m_num_bytes_written += sizeof(Vector4_32);
+		WriterType::write_bone_translation(bone_index, translation);
+	}
+
+	uint64_t m_num_bytes_written;
+};
+
+struct ConstantTrackCacheDecompressionSettings : public uniformly_sampled::DecompressionSettings
+{
+	constexpr bool use_constant_track_cache() const { return true; }
+};
+
+// The object space writer only needs the parent of every bone, not the whole skeleton
+static uint16_t* allocate_parent_indices(Allocator& allocator, const RigidSkeleton& skeleton)
+{
+	uint16_t num_bones = skeleton.get_num_bones();
+	uint16_t* parent_indices = allocate_type_array<uint16_t>(allocator, num_bones);
+	for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+		parent_indices[bone_index] = skeleton.get_bones()[bone_index].parent_index;
+	return parent_indices;
+}
+
+// Compresses an additive clip where one bone in ten is animated, relative to the first sample of the input clip
+static CompressedClip* compress_additive_clip(Allocator& allocator, const AnimationClip& clip, const RigidSkeleton& skeleton, IAlgorithm& algorithm)
+{
+	const uint16_t num_bones = clip.get_num_bones();
+	const uint32_t num_samples = clip.get_num_samples();
+
+	AnimationClip additive_clip(allocator, skeleton, num_samples, clip.get_sample_rate(), clip.get_name(), clip.get_error_threshold());
+
+	for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+	{
+		const AnimatedBone& bone = clip.get_animated_bone(bone_index);
+		AnimatedBone& additive_bone = additive_clip.get_bones()[bone_index];
+		const bool is_animated = (bone_index % 10) == 0;
+
+		const Quat_64 inv_reference_rotation = quat_conjugate(bone.rotation_track.get_sample(0));
+		const Vector4_64 reference_translation = bone.translation_track.get_sample(0);
+
+		for (uint32_t sample_index = 0; sample_index < num_samples; ++sample_index)
+		{
+			if (is_animated)
+			{
+				additive_bone.rotation_track.set_sample(sample_index, quat_normalize(quat_mul(bone.rotation_track.get_sample(sample_index), inv_reference_rotation)));
+				additive_bone.translation_track.set_sample(sample_index, vector_sub(bone.translation_track.get_sample(sample_index), reference_translation));
+			}
+			else
+			{
+				additive_bone.rotation_track.set_sample(sample_index, quat_identity_64());
+				additive_bone.translation_track.set_sample(sample_index, vector_zero_64());
+			}
+		}
+	}
+
+	OutputStats stats;
+	return algorithm.compress_clip(allocator, additive_clip, skeleton, stats);
+}
+
+// Compares decompressing an additive clip into a scratch pose then composing it with applying it in place
+static void benchmark_additive_decompression(Allocator& allocator, const AnimationClip& clip, const RigidSkeleton& skeleton, IAlgorithm& algorithm, SJSONObjectWriter& writer)
+{
+	using namespace uniformly_sampled;
+
+	const uint16_t num_bones = clip.get_num_bones();
+	const uint16_t num_animated_bones = (num_bones + 9) / 10;
+
+	CompressedClip* compressed_additive_clip = compress_additive_clip(allocator, clip, skeleton, algorithm);
+
+	DecompressionSettings settings;
+	void* context = allocate_decompression_context(allocator, settings, *compressed_additive_clip);
+	Transform_32* base_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* additive_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	clip.sample_pose(0.0f, base_pose_transforms, num_bones);
+
+	const float additive_weight = 0.5f;
+
+	writer["num_animated_bones"] = num_animated_bones;
+
+	writer["two_pass_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+	{
+		DefaultOutputWriter pose_writer(additive_pose_transforms, num_bones);
+		decompress_pose(settings, *compressed_additive_clip, context, sample_time, pose_writer);
+
+		for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+		{
+			const Quat_32 additive_rotation = quat_lerp(quat_identity_32(), additive_pose_transforms[bone_index].rotation, additive_weight);
+			base_pose_transforms[bone_index].rotation = quat_normalize(quat_mul(additive_rotation, base_pose_transforms[bone_index].rotation));
+			base_pose_transforms[bone_index].translation = vector_add(base_pose_transforms[bone_index].translation, vector_mul(additive_pose_transforms[bone_index].translation, additive_weight));
+		}
+	});
+
+	writer["in_place_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+	{
+		AdditiveOutputWriter pose_writer(base_pose_transforms, num_bones, additive_weight);
+		decompress_pose(settings, *compressed_additive_clip, context, sample_time, pose_writer);
+	});
+
+	deallocate_type_array(allocator, additive_pose_transforms, num_bones);
+	deallocate_type_array(allocator, base_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, context);
+	allocator.deallocate(compressed_additive_clip, compressed_additive_clip->get_size());
+}
+
+static void benchmark_decompression(Allocator& allocator, const AnimationClip& clip, const RigidSkeleton& skeleton, const CompressedClip& compressed_clip, IAlgorithm& algorithm, SJSONObjectWriter& writer)
+{
+	using namespace uniformly_sampled;
+
+	ACL_ENSURE(compressed_clip.get_algorithm_type() == AlgorithmType8::UniformlySampled, "Only the uniformly sampled algorithm can be benchmarked");
+
+	uint16_t num_bones = clip.get_num_bones();
+	const uniformly_sampled::impl::ClipHeader& header = uniformly_sampled::impl::get_clip_header(compressed_clip);
+
+	DecompressionSettings settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	DecodePlanDecompressionSettings decode_plan_settings;
+	void* decode_plan_context = allocate_decompression_context(allocator, decode_plan_settings, compressed_clip);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+
+	writer["decompression"] = [&](SJSONObjectWriter& writer)
+	{
+		writer["num_segments"] = header.num_segments;
+		writer["context_size"] = uint32_t(get_decompression_context_size(context));
+		writer["decode_plan_context_size"] = uint32_t(get_decompression_context_size(decode_plan_context));
+
+		{
+			void* key_frame_cache_context = allocate_decompression_context(allocator, KeyFrameCacheDecompressionSettings(), compressed_clip);
+			writer["key_frame_cache_context_size"] = uint32_t(get_decompression_context_size(key_frame_cache_context));
+			deallocate_decompression_context(allocator, key_frame_cache_context);
+		}
+
+		writer["pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+		{
+			DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+		});
+
+		writer["num_bones"] = num_bones;
+
+		writer["object_space_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+		{
+			DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+			local_to_object_space(skeleton, lossy_pose_transforms, lossy_pose_transforms);
+		});
+
+		{
+			uint16_t* parent_indices = allocate_parent_indices(allocator, skeleton);
+			writer["fused_object_space_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				ObjectSpaceOutputWriter pose_writer(parent_indices, lossy_pose_transforms, num_bones);
+				decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+			});
+			deallocate_type_array(allocator, parent_indices, num_bones);
+		}
+
+		{
+			// Skinning matrices, converted after the decompression or fused within it
+			// The inverse bind pose values do not matter for timing purposes, identity is fine
+			uint16_t* parent_indices = allocate_parent_indices(allocator, skeleton);
+			float* skinning_matrices = allocate_type_array_aligned<float>(allocator, size_t(num_bones) * Matrix3x4OutputWriter::NUM_FLOATS_PER_MATRIX, 16);
+			Transform_32* inverse_bind_pose = allocate_type_array<Transform_32>(allocator, num_bones);
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+				inverse_bind_pose[bone_index] = transform_identity_32();
+
+			double convert_pose_time = measure_decompression_time(clip, [&](float sample_time)
+			{
+				DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+				decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+				local_to_object_space(skeleton, lossy_pose_transforms, lossy_pose_transforms);
+
+				for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+				{
+					Transform_32 skinning_transform = transform_mul(inverse_bind_pose[bone_index], lossy_pose_transforms[bone_index]);
+
+					Vector4_32 row0;
+					Vector4_32 row1;
+					Vector4_32 row2;
+					matrix3x4_from_rotation_translation(skinning_transform.rotation, skinning_transform.translation, row0, row1, row2);
+
+					float* matrix = skinning_matrices + (bone_index * Matrix3x4OutputWriter::NUM_FLOATS_PER_MATRIX);
+					vector_unaligned_write(row0, matrix + 0);
+					vector_unaligned_write(row1, matrix + 4);
+					vector_unaligned_write(row2, matrix + 8);
+				}
+			});
+
+			double fused_pose_time = measure_decompression_time(clip, [&](float sample_time)
+			{
+				Matrix3x4OutputWriter pose_writer(parent_indices, lossy_pose_transforms, skinning_matrices, num_bones, inverse_bind_pose);
+				decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+			});
+
+			writer["matrix_convert_pose_time"] = convert_pose_time;
+			writer["matrix_fused_pose_time"] = fused_pose_time;
+			writer["matrix_convert_bones_per_second"] = convert_pose_time > 0.0 ? double(num_bones) / convert_pose_time : 0.0;
+			writer["matrix_fused_bones_per_second"] = fused_pose_time > 0.0 ? double(num_bones) / fused_pose_time : 0.0;
+
+			deallocate_type_array(allocator, inverse_bind_pose, num_bones);
+			deallocate_type_array(allocator, skinning_matrices, size_t(num_bones) * Matrix3x4OutputWriter::NUM_FLOATS_PER_MATRIX);
+			deallocate_type_array(allocator, parent_indices, num_bones);
+		}
+
+		{
+			// Cross-fade the clip with itself played backwards, blending into a third pose or fused
+			void* blend_context = allocate_decompression_context(allocator, settings, compressed_clip);
+			Transform_32* blend_pose_transforms0 = allocate_type_array<Transform_32>(allocator, num_bones);
+			Transform_32* blend_pose_transforms1 = allocate_type_array<Transform_32>(allocator, num_bones);
+			const float duration = clip.get_duration();
+			const float blend_weight = 0.3f;
+
+			writer["blend_two_pass_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				DefaultOutputWriter pose_writer0(blend_pose_transforms0, num_bones);
+				decompress_pose(settings, compressed_clip, context, sample_time, pose_writer0);
+
+				DefaultOutputWriter pose_writer1(blend_pose_transforms1, num_bones);
+				decompress_pose(settings, compressed_clip, blend_context, duration - sample_time, pose_writer1);
+
+				for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+				{
+					lossy_pose_transforms[bone_index].rotation = quat_lerp(blend_pose_transforms0[bone_index].rotation, blend_pose_transforms1[bone_index].rotation, blend_weight);
+					lossy_pose_transforms[bone_index].translation = vector_lerp(blend_pose_transforms0[bone_index].translation, blend_pose_transforms1[bone_index].translation, blend_weight);
+				}
+			});
+
+			writer["blend_fused_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+				decompress_blended_pose(settings, compressed_clip, context, sample_time, compressed_clip, blend_context, duration - sample_time, blend_weight, nullptr, pose_writer);
+			});
+
+			// Partial blend where only the second half of the bones comes from the second clip
+			float* bone_weights = allocate_type_array<float>(allocator, num_bones);
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+				bone_weights[bone_index] = bone_index < (num_bones / 2) ? 0.0f : 1.0f;
+
+			writer["blend_fused_masked_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+				decompress_blended_pose(settings, compressed_clip, context, sample_time, compressed_clip, blend_context, duration - sample_time, 1.0f, bone_weights, pose_writer);
+			});
+
+			deallocate_type_array(allocator, bone_weights, num_bones);
+			deallocate_type_array(allocator, blend_pose_transforms1, num_bones);
+			deallocate_type_array(allocator, blend_pose_transforms0, num_bones);
+			deallocate_decompression_context(allocator, blend_context);
+		}
+
+		{
+			// Motion matching query: 2 past and 3 future trajectory points for 12 bones
+			const uint32_t num_query_times = 5;
+			const uint16_t num_query_bones = std::min<uint16_t>(num_bones, 12);
+			const float query_time_offsets[num_query_times] = { -0.2f, -0.1f, 0.33f, 0.66f, 1.0f };
+			const float duration = clip.get_duration();
+
+			uint16_t query_bone_indices[12];
+			for (uint16_t query_bone_index = 0; query_bone_index < num_query_bones; ++query_bone_index)
+				query_bone_indices[query_bone_index] = uint16_t((uint32_t(query_bone_index) * num_bones) / num_query_bones);
+
+			Transform_32 query_transforms[num_query_times * 12];
+			float query_times[num_query_times];
+
+			// The queried bones don't change, the mask is built once
+			void* query_bone_mask = allocate_bone_mask(allocator, settings, compressed_clip, query_bone_indices, num_query_bones);
+
+			writer["motion_matching_num_times"] = num_query_times;
+			writer["motion_matching_num_bones"] = num_query_bones;
+
+			writer["motion_matching_decompress_bone_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				for (uint32_t time_index = 0; time_index < num_query_times; ++time_index)
+				{
+					const float query_time = clamp(sample_time + query_time_offsets[time_index], 0.0f, duration);
+					for (uint16_t query_bone_index = 0; query_bone_index < num_query_bones; ++query_bone_index)
+					{
+						Transform_32& transform = query_transforms[(time_index * num_query_bones) + query_bone_index];
+						decompress_bone(settings, compressed_clip, context, query_time, query_bone_indices[query_bone_index], &transform.rotation, &transform.translation);
+					}
+				}
+			});
+
+			writer["motion_matching_bones_at_times_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				for (uint32_t time_index = 0; time_index < num_query_times; ++time_index)
+					query_times[time_index] = clamp(sample_time + query_time_offsets[time_index], 0.0f, duration);
+
+				decompress_bones_at_times(settings, compressed_clip, context, query_bone_mask, query_times, num_query_times, query_transforms);
+			});
+
+			deallocate_bone_mask(allocator, query_bone_mask);
+		}
+
+		{
+			// Root motion of a looping clip played at 30 FPS, the previous frame wraps around at the start
+			const float duration = clip.get_duration();
+			const float frame_delta_time = 1.0f / 30.0f;
+			Transform_32 root_motion_delta;
+
+			writer["root_motion_decompress_bone_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				const float previous_sample_time = sample_time >= frame_delta_time ? (sample_time - frame_delta_time) : std::max(duration + sample_time - frame_delta_time, 0.0f);
+
+				Transform_32 previous_root_transform;
+				Transform_32 root_transform;
+				decompress_bone(settings, compressed_clip, context, previous_sample_time, 0, &previous_root_transform.rotation, &previous_root_transform.translation);
+				decompress_bone(settings, compressed_clip, context, sample_time, 0, &root_transform.rotation, &root_transform.translation);
+
+				root_motion_delta = transform_mul(root_transform, transform_inverse(previous_root_transform));
+			});
+
+			writer["root_motion_delta_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				const float previous_sample_time = sample_time >= frame_delta_time ? (sample_time - frame_delta_time) : std::max(duration + sample_time - frame_delta_time, 0.0f);
+
+				root_motion_delta = decompress_root_motion_delta(settings, compressed_clip, context, previous_sample_time, sample_time, true);
+			});
+
+			(void)root_motion_delta;
+		}
+
+		writer["rotation_only_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+		{
+			RotationOnlyOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+		});
+
+		writer["translation_only_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+		{
+			TranslationOnlyOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+		});
+
+		writer["bone_mask"] = [&](SJSONArrayWriter& writer)
+		{
+			const uint32_t bone_percentages[] = { 10, 25, 50 };
+			for (uint32_t bone_percentage : bone_percentages)
+			{
+				// Spread the masked bones evenly over the skeleton
+				uint16_t num_masked_bones = std::max<uint16_t>(uint16_t((num_bones * bone_percentage) / 100), 1);
+				uint16_t* bone_indices = allocate_type_array<uint16_t>(allocator, num_masked_bones);
+				for (uint16_t mask_index = 0; mask_index < num_masked_bones; ++mask_index)
+					bone_indices[mask_index] = uint16_t((uint32_t(mask_index) * num_bones) / num_masked_bones);
+
+				void* bone_mask = allocate_bone_mask(allocator, settings, compressed_clip, bone_indices, num_masked_bones);
+
+				writer.push_object([&](SJSONObjectWriter& writer)
+				{
+					writer["bone_percentage"] = bone_percentage;
+					writer["num_bones"] = num_masked_bones;
+					writer["pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+					{
+						DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+						decompress_partial_pose(settings, compressed_clip, context, bone_mask, sample_time, pose_writer);
+					});
+				});
+
+				deallocate_bone_mask(allocator, bone_mask);
+				deallocate_type_array(allocator, bone_indices, num_masked_bones);
+			}
+		};
+
+		writer["decode_plan_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+		{
+			DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(decode_plan_settings, compressed_clip, decode_plan_context, sample_time, pose_writer);
+		});
+
+		{
+			ConstantTrackCacheDecompressionSettings constant_cache_settings;
+			void* constant_cache_context = allocate_decompression_context(allocator, constant_cache_settings, compressed_clip);
+
+			const uint32_t num_tracks = uint32_t(num_bones) * uniformly_sampled::impl::Constants::NUM_TRACKS_PER_BONE;
+			const uint32_t bitset_size = get_bitset_size(num_tracks);
+
+			uint32_t num_constant_tracks = 0;
+			for (uint32_t track_index = 0; track_index < num_tracks; ++track_index)
+			{
+				if (!bitset_test(header.get_default_tracks_bitset(), bitset_size, track_index) && bitset_test(header.get_constant_tracks_bitset(), bitset_size, track_index))
+					num_constant_tracks++;
+			}
+
+			writer["num_constant_tracks"] = num_constant_tracks;
+			writer["constant_track_cache_context_size"] = uint32_t(get_decompression_context_size(constant_cache_context));
+			writer["constant_track_cache_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+				decompress_pose(constant_cache_settings, compressed_clip, constant_cache_context, sample_time, pose_writer);
+			});
+
+			deallocate_decompression_context(allocator, constant_cache_context);
+		}
+
+		// A long-lived instance writes its invariant tracks once and afterwards only its animated tracks
+		{
+			uint32_t num_samples = calculate_num_samples(clip.get_duration(), clip.get_sample_rate());
+			float sample_rate = float(clip.get_sample_rate());
+
+			ByteCountingOutputWriter<DefaultOutputWriter> full_pose_writer(lossy_pose_transforms, num_bones);
+			ByteCountingOutputWriter<PersistentPoseOutputWriter> persistent_pose_writer(lossy_pose_transforms, num_bones);
+
+			for (uint32_t sample_index = 0; sample_index < num_samples; ++sample_index)
+			{
+				float sample_time = min(float(sample_index) / sample_rate, clip.get_duration());
+				decompress_pose(settings, compressed_clip, context, sample_time, full_pose_writer);
+
+				persistent_pose_writer.begin_pose(compressed_clip);
+				decompress_pose(settings, compressed_clip, context, sample_time, persistent_pose_writer);
+			}
+
+			writer["full_pose_bytes_written_per_pose"] = double(full_pose_writer.m_num_bytes_written) / double(num_samples);
+			writer["persistent_pose_bytes_written_per_pose"] = double(persistent_pose_writer.m_num_bytes_written) / double(num_samples);
+
+			PersistentPoseOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			writer["persistent_pose_time"] = measure_decompression_time(clip, [&](float sample_time)
+			{
+				pose_writer.begin_pose(compressed_clip);
+				decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+			});
+		}
+
+		// Sampling the first bone is dominated by the cost of seeking
+		writer["seek_time"] = measure_decompression_time(clip, [&](float sample_time)
+		{
+			Quat_32 rotation;
+			Vector4_32 translation;
+			decompress_bone(settings, compressed_clip, context, sample_time, 0, &rotation, &translation);
+		});
+
+		// Sampling the last bone measures the cost of skipping every other bone
+		writer["last_bone_time"] = measure_decompression_time(clip, [&](float sample_time)
+		{
+			Quat_32 rotation;
+			Vector4_32 translation;
+			decompress_bone(settings, compressed_clip, context, sample_time, num_bones - 1, &rotation, &translation);
+		});
+
+		{
+			uint8_t* flush_buffer = allocate_type_array<uint8_t>(allocator, COLD_CACHE_FLUSH_BUFFER_SIZE);
+			std::memset(flush_buffer, 0, COLD_CACHE_FLUSH_BUFFER_SIZE);
+
+			writer["cold_pose_time"] = measure_cold_decompression_time(allocator, clip, compressed_clip, settings, flush_buffer);
+			writer["cold_prefetch_pose_time"] = measure_cold_decompression_time(allocator, clip, compressed_clip, PrefetchDecompressionSettings(), flush_buffer);
+
+			deallocate_type_array(allocator, flush_buffer, COLD_CACHE_FLUSH_BUFFER_SIZE);
+		}
+
+		writer["playback"] = [&](SJSONArrayWriter& writer)
+		{
+			const float frame_rates[] = { 30.0f, 60.0f, 120.0f, 144.0f };
+			for (float frame_rate : frame_rates)
+			{
+				writer.push_object([&](SJSONObjectWriter& writer)
+				{
+					writer["frame_rate"] = frame_rate;
+					writer["seek_frame_time"] = measure_playback_time(allocator, clip, compressed_clip, settings, frame_rate);
+					writer["cursor_frame_time"] = measure_playback_time(allocator, clip, compressed_clip, PlaybackCursorDecompressionSettings(), frame_rate);
+					writer["key_frame_cache_frame_time"] = measure_playback_time(allocator, clip, compressed_clip, KeyFrameCacheDecompressionSettings(), frame_rate);
+				});
+			}
+		};
+
+		writer["additive"] = [&](SJSONObjectWriter& writer) { benchmark_additive_decompression(allocator, clip, skeleton, algorithm, writer); };
+		writer["crowd"] = [&](SJSONArrayWriter& writer) { benchmark_crowd_decompression(allocator, clip, compressed_clip, writer); };
+		writer["multithreaded"] = [&](SJSONArrayWriter& writer) { benchmark_multithreaded_decompression(allocator, clip, compressed_clip, writer); };
+		writer["vector3_n_unpack"] = [&](SJSONObjectWriter& writer) { benchmark_variable_unpacking(writer); };
+	};
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, decode_plan_context);
+	deallocate_decompression_context(allocator, context);
+}
+
+// Compresses the clip with a segmented variable bit rate format using an increasing number of quantization threads.
+// The compressed clip must be identical to the one compressed with a single thread.
+static void benchmark_parallel_quantization(Allocator& allocator, const AnimationClip& clip, const RigidSkeleton& skeleton, SJSONArrayWriter& writer)
+{
+	constexpr uint16_t THREAD_COUNTS[] = { 1, 2, 4, 8, 16 };
+
+	uniformly_sampled::CompressionSettings settings;
+	settings.rotation_format = RotationFormat8::QuatDropW_Variable;
+	settings.translation_format = VectorFormat8::Vector3_Variable;
+	settings.range_reduction = RangeReductionFlags8::Rotations | RangeReductionFlags8::Translations;
+	settings.segmenting.enabled = true;
+	settings.segmenting.range_reduction = RangeReductionFlags8::Rotations | RangeReductionFlags8::Translations;
+
+	CompressedClip* reference_clip = nullptr;
+
+	for (uint16_t num_threads : THREAD_COUNTS)
+	{
+		settings.num_quantization_threads = num_threads;
+
+		OutputStats stats;
+		ScopeProfiler timer;
+		CompressedClip* compressed_clip = uniformly_sampled::compress_clip(allocator, clip, skeleton, settings, stats);
+		timer.stop();
+
+		if (reference_clip == nullptr)
+			reference_clip = compressed_clip;
+
+		const bool is_identical = compressed_clip->get_size() == reference_clip->get_size() && std::memcmp(compressed_clip, reference_clip, compressed_clip->get_size()) == 0;
+		ACL_ENSURE(is_identical, "Compressing with %u quantization threads changed the compressed clip", num_threads);
+
+		writer.push_object([&](SJSONObjectWriter& writer)
+		{
+			writer["num_threads"] = num_threads;
+			writer["compression_time"] = cycles_to_seconds(timer.get_elapsed_cycles());
+			writer["is_identical"] = is_identical;
+		});
+
+		if (compressed_clip != reference_clip)
+			allocator.deallocate(compressed_clip, compressed_clip->get_size());
+	}
+
+	allocator.deallocate(reference_clip, reference_clip->get_size());
+}
+
+// The object space error used to rebuild the parent chain with a recursive std::function, kept as a reference
+static float calculate_object_bone_error_recursive(const RigidSkeleton& skeleton, const Transform_32* raw_local_pose, const Transform_32* lossy_local_pose, uint16_t bone_index)
+{
+	const RigidBone& target_bone = skeleton.get_bone(bone_index);
+	float vtx_distance = float(target_bone.vertex_distance);
+
+	std::function<Transform_32(const Transform_32*, uint16_t)> apply_fun;
+	apply_fun = [&](const Transform_32* local_pose, uint16_t bone_index) -> Transform_32
+	{
+		if (bone_index == 0)
+			return local_pose[0];
+		const RigidBone& bone = skeleton.get_bone(bone_index);
+		Transform_32 parent_transform = apply_fun(local_pose, bone.parent_index);
+		return transform_mul(local_pose[bone_index], parent_transform);
+	};
+
+	Transform_32 raw_obj_transform = apply_fun(raw_local_pose, bone_index);
+	Transform_32 lossy_obj_transform = apply_fun(lossy_local_pose, bone_index);
+
+	Vector4_32 vtx0 = vector_set(vtx_distance, 0.0f, 0.0f);
+	Vector4_32 vtx1 = vector_set(0.0f, vtx_distance, 0.0f);
+
+	float vtx0_error = vector_distance3(transform_position(raw_obj_transform, vtx0), transform_position(lossy_obj_transform, vtx0));
+	float vtx1_error = vector_distance3(transform_position(raw_obj_transform, vtx1), transform_position(lossy_obj_transform, vtx1));
+
+	return max(vtx0_error, vtx1_error);
+}
+
+// Measures the object space error of the leaf bone of 5, 15 and 30 bone deep chains
+static void benchmark_object_bone_error(Allocator& allocator, SJSONArrayWriter& writer)
+{
+	constexpr uint16_t CHAIN_LENGTHS[] = { 5, 15, 30 };
+	constexpr uint32_t NUM_ERROR_ITERATIONS = 100000;
+
+	for (uint16_t num_bones : CHAIN_LENGTHS)
+	{
+		RigidBone* bones = allocate_type_array<RigidBone>(allocator, num_bones);
+		for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			bones[bone_index].parent_index = bone_index == 0 ? INVALID_BONE_INDEX : uint16_t(bone_index - 1);
+
+		RigidSkeleton skeleton(allocator, bones, num_bones);
+		deallocate_type_array(allocator, bones, num_bones);
+
+		Transform_32* raw_local_pose = allocate_type_array<Transform_32>(allocator, num_bones);
+		Transform_32* lossy_local_pose = allocate_type_array<Transform_32>(allocator, num_bones);
+		for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+		{
+			float angle = float(bone_index) * 0.1f;
+			raw_local_pose[bone_index] = transform_set(quat_from_euler(angle, 0.0f, angle * 0.5f), vector_set(1.0f, 0.0f, 0.0f));
+			lossy_local_pose[bone_index] = transform_set(quat_from_euler(angle + 0.001f, 0.0f, angle * 0.5f), vector_set(1.001f, 0.0f, 0.0f));
+		}
+
+		const uint16_t leaf_bone_index = num_bones - 1;
+
+		auto measure_error_time = [&](auto error_fun, float& out_error)
+		{
+			float error_sum = 0.0f;
+
+			ScopeProfiler timer;
+			for (uint32_t iteration = 0; iteration < NUM_ERROR_ITERATIONS; ++iteration)
+				error_sum += error_fun(skeleton, raw_local_pose, lossy_local_pose, leaf_bone_index);
+			timer.stop();
+
+			// Keep the result alive so the loop isn't optimized away
+			out_error = error_sum;
+
+			// Average time in seconds per error calculated
+			return cycles_to_seconds(timer.get_elapsed_cycles()) / double(NUM_ERROR_ITERATIONS);
+		};
+
+		float recursive_error;
+		float iterative_error;
+		const double recursive_time = measure_error_time(calculate_object_bone_error_recursive, recursive_error);
+		const double iterative_time = measure_error_time(calculate_object_bone_error, iterative_error);
+		ACL_ENSURE(recursive_error == iterative_error, "Object space error mismatch: %f != %f", recursive_error, iterative_error);
+
+		writer.push_object([&](SJSONObjectWriter& writer)
+		{
+			writer["chain_length"] = num_bones;
+			writer["recursive_time"] = recursive_time;
+			writer["iterative_time"] = iterative_time;
+		});
+
+		deallocate_type_array(allocator, raw_local_pose, num_bones);
+		deallocate_type_array(allocator, lossy_local_pose, num_bones);
+	}
+}
+
+// The SIMD path of unpack_vector3_n must match the scalar path exactly, at every bit rate and bit offset
+static void validate_variable_unpacking()
+{
+	// Enough padding for the last 64 bit load
+	uint8_t packed_data[64 + 8];
+	for (uint32_t byte_index = 0; byte_index < sizeof(packed_data); ++byte_index)
+		packed_data[byte_index] = uint8_t((byte_index * 37) ^ (byte_index >> 1));
+
+	for (uint8_t bit_rate = LOWEST_BIT_RATE; bit_rate < HIGHEST_BIT_RATE; ++bit_rate)
+	{
+		const uint8_t num_bits = get_num_bits_at_bit_rate(bit_rate);
+		for (uint64_t bit_offset = 0; bit_offset + (num_bits * 3) <= 64 * 8; bit_offset += 5)
+		{
+			for (bool is_unsigned : { true, false })
+			{
+				const Vector4_32 scalar_value = unpack_vector3_n_scalar(num_bits, is_unsigned, packed_data, bit_offset);
+				const Vector4_32 value = unpack_vector3_n(num_bits, num_bits, num_bits, is_unsigned, packed_data, bit_offset);
+				ACL_ENSURE(std::memcmp(&value, &scalar_value, sizeof(float) * 3) == 0, "Unpacked vector mismatch with %u bits at bit offset %llu", num_bits, bit_offset);
+			}
+		}
+	}
+}
+
+// Decompression paths that read the same key frames must produce the exact same pose
+static void validate_poses_match(const Transform_32* pose_transforms, const Transform_32* reference_pose_transforms, uint16_t num_bones, float sample_time, const char* description)
+{
+	for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+	{
+		const Transform_32& transform = pose_transforms[bone_index];
+		const Transform_32& reference_transform = reference_pose_transforms[bone_index];
+		ACL_ENSURE(std::memcmp(&transform.rotation, &reference_transform.rotation, sizeof(Quat_32)) == 0, "%s: rotation mismatch for bone %u at time %f", description, bone_index, sample_time);
+		ACL_ENSURE(std::memcmp(&transform.translation, &reference_transform.translation, sizeof(float) * 3) == 0, "%s: translation mismatch for bone %u at time %f", description, bone_index, sample_time);
+	}
+}
+
+// Calls the provided function at every key frame and halfway between consecutive key frames
+template<typename SampleFunType>
+static void for_each_validation_sample_time(const AnimationClip& clip, SampleFunType sample_fun)
+{
+	float clip_duration = clip.get_duration();
+	float sample_rate = float(clip.get_sample_rate());
+	uint32_t num_samples = calculate_num_samples(clip_duration, clip.get_sample_rate());
+
+	for (uint32_t half_sample_index = 0; half_sample_index < (num_samples * 2) - 1; ++half_sample_index)
+		sample_fun(min(float(half_sample_index) / (sample_rate * 2.0f), clip_duration));
+}
+
+// Plays the clip forward then backward, at every key frame and halfway between consecutive key frames,
+// then jumps back and forth over every segment boundary
+static std::vector<float> get_playback_sample_times(const AnimationClip& clip, const CompressedClip& compressed_clip)
+{
+	const uniformly_sampled::impl::ClipHeader& header = uniformly_sampled::impl::get_clip_header(compressed_clip);
+	float clip_duration = clip.get_duration();
+	float sample_rate = float(clip.get_sample_rate());
+
+	std::vector<float> sample_times;
+	for_each_validation_sample_time(clip, [&](float sample_time) { sample_times.push_back(sample_time); });
+
+	const size_t num_forward_sample_times = sample_times.size();
+	for (size_t sample_index = num_forward_sample_times; sample_index-- > 0;)
+		sample_times.push_back(sample_times[sample_index]);
+
+	const uint32_t* segment_start_indices = header.get_segment_start_indices();
+	const float half_sample_duration = 0.5f / sample_rate;
+	for (uint32_t segment_index = 1; segment_index < header.num_segments; ++segment_index)
+	{
+		const float segment_start_time = float(segment_start_indices[segment_index]) / sample_rate;
+		sample_times.push_back(segment_start_time - half_sample_duration);
+		sample_times.push_back(segment_start_time);
+		sample_times.push_back(min(segment_start_time + half_sample_duration, clip_duration));
+		sample_times.push_back(segment_start_time - (half_sample_duration * 3.0f));
+		sample_times.push_back(min(segment_start_time + (half_sample_duration * 3.0f), clip_duration));
+	}
+
+	return sample_times;
+}
+
+// The playback cursor and the key frame cache reuse what the previous seek found or decompressed,
+// every pose must match a cursor that samples without any history
+template<class SettingsType>
+static void validate_playback(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, const SettingsType& cursor_settings, const char* description)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	DecompressionSettings settings;
+	SharedDecompressionContext shared_context;
+	initialize_shared_decompression_context(settings, compressed_clip, shared_context);
+	void* cursor_context = allocate_decompression_context(allocator, cursor_settings, compressed_clip);
+	Transform_32* reference_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+
+	for (float sample_time : get_playback_sample_times(clip, compressed_clip))
+	{
+		DecompressionCursor cursor;
+		initialize_decompression_cursor(shared_context, cursor);
+		DefaultOutputWriter reference_pose_writer(reference_pose_transforms, num_bones);
+		decompress_pose(settings, compressed_clip, &cursor, sample_time, reference_pose_writer);
+
+		DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+		decompress_pose(cursor_settings, compressed_clip, cursor_context, sample_time, pose_writer);
+		validate_poses_match(lossy_pose_transforms, reference_pose_transforms, num_bones, sample_time, description);
+
+		// A single bone seeks with the same cursor
+		const uint16_t sample_bone_index = num_bones - 1;
+		Quat_32 rotation;
+		Vector4_32 translation;
+		decompress_bone(cursor_settings, compressed_clip, cursor_context, sample_time, sample_bone_index, &rotation, &translation);
+		ACL_ENSURE(std::memcmp(&rotation, &reference_pose_transforms[sample_bone_index].rotation, sizeof(Quat_32)) == 0, "%s: rotation mismatch for bone %u at time %f", description, sample_bone_index, sample_time);
+		ACL_ENSURE(std::memcmp(&translation, &reference_pose_transforms[sample_bone_index].translation, sizeof(float) * 3) == 0, "%s: translation mismatch for bone %u at time %f", description, sample_bone_index, sample_time);
+	}
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, reference_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, cursor_context);
+}
+
+// Cursors share the read-only clip state, interleaving two of them on one shared context must produce
+// the same poses as two independent contexts playing the same sample times
+template<class SettingsType>
+static void validate_shared_context(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, const SettingsType& settings, const char* description)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	SharedDecompressionContext shared_context;
+	initialize_shared_decompression_context(settings, compressed_clip, shared_context);
+
+	DecompressionCursor cursors[2];
+	void* contexts[2];
+	for (uint32_t cursor_index = 0; cursor_index < 2; ++cursor_index)
+	{
+		initialize_decompression_cursor(shared_context, cursors[cursor_index]);
+		contexts[cursor_index] = allocate_decompression_context(allocator, settings, compressed_clip);
+	}
+
+	Transform_32* reference_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+
+	// The first cursor plays forward while the second plays backward
+	const std::vector<float> sample_times = get_playback_sample_times(clip, compressed_clip);
+	const size_t num_sample_times = sample_times.size();
+	for (size_t sample_index = 0; sample_index < num_sample_times; ++sample_index)
+	{
+		for (uint32_t cursor_index = 0; cursor_index < 2; ++cursor_index)
+		{
+			const float sample_time = sample_times[cursor_index == 0 ? sample_index : (num_sample_times - sample_index - 1)];
+
+			DefaultOutputWriter reference_pose_writer(reference_pose_transforms, num_bones);
+			decompress_pose(settings, compressed_clip, contexts[cursor_index], sample_time, reference_pose_writer);
+
+			DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(settings, compressed_clip, &cursors[cursor_index], sample_time, pose_writer);
+			validate_poses_match(lossy_pose_transforms, reference_pose_transforms, num_bones, sample_time, description);
+		}
+	}
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, reference_pose_transforms, num_bones);
+	for (uint32_t cursor_index = 0; cursor_index < 2; ++cursor_index)
+		deallocate_decompression_context(allocator, contexts[cursor_index]);
+}
+
+// A partial pose must write the masked bones exactly as the full pose does and never touch the other bones
+static void validate_partial_pose(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	DecompressionSettings settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	Transform_32* reference_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	uint16_t* bone_indices = allocate_type_array<uint16_t>(allocator, num_bones);
+
+	// Unwritten bones keep this value, it is not a valid transform
+	const Transform_32 untouched_transform = transform_set(quat_set(2.0f, 2.0f, 2.0f, 2.0f), vector_set(-1.0f));
+
+	// The first bone only, the last bone only, and every third bone
+	const uint16_t mask_strides[] = { num_bones, 1, 3 };
+	for (uint16_t mask_stride : mask_strides)
+	{
+		uint16_t num_masked_bones = 0;
+		for (uint16_t bone_index = mask_stride == 1 ? (num_bones - 1) : 0; bone_index < num_bones; bone_index += mask_stride)
+			bone_indices[num_masked_bones++] = bone_index;
+
+		void* bone_mask = allocate_bone_mask(allocator, settings, compressed_clip, bone_indices, num_masked_bones);
+
+		for_each_validation_sample_time(clip, [&](float sample_time)
+		{
+			DefaultOutputWriter reference_pose_writer(reference_pose_transforms, num_bones);
+			decompress_pose(settings, compressed_clip, context, sample_time, reference_pose_writer);
+
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+				lossy_pose_transforms[bone_index] = untouched_transform;
+
+			DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_partial_pose(settings, compressed_clip, context, bone_mask, sample_time, pose_writer);
+
+			uint16_t mask_index = 0;
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			{
+				const bool is_masked = mask_index < num_masked_bones && bone_indices[mask_index] == bone_index;
+				const Transform_32& expected_transform = is_masked ? reference_pose_transforms[bone_index] : untouched_transform;
+				if (is_masked)
+					mask_index++;
+
+				ACL_ENSURE(std::memcmp(&lossy_pose_transforms[bone_index].rotation, &expected_transform.rotation, sizeof(Quat_32)) == 0, "Partial pose: rotation mismatch for bone %u at time %f", bone_index, sample_time);
+				ACL_ENSURE(std::memcmp(&lossy_pose_transforms[bone_index].translation, &expected_transform.translation, sizeof(float) * 3) == 0, "Partial pose: translation mismatch for bone %u at time %f", bone_index, sample_time);
+			}
+		});
+
+		deallocate_bone_mask(allocator, bone_mask);
+	}
+
+	deallocate_type_array(allocator, bone_indices, num_bones);
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, reference_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, context);
+}
+
+// Compresses a copy of the clip with every bone offset by the same rotation and translation, the copy has the
+// same animated tracks but different values
+static CompressedClip* compress_offset_clip(Allocator& allocator, const AnimationClip& clip, const RigidSkeleton& skeleton, IAlgorithm& algorithm)
+{
+	const uint16_t num_bones = clip.get_num_bones();
+	const uint32_t num_samples = clip.get_num_samples();
+
+	AnimationClip offset_clip(allocator, skeleton, num_samples, clip.get_sample_rate(), clip.get_name(), clip.get_error_threshold());
+
+	const Quat_64 offset_rotation = quat_from_euler(deg2rad(10.0), deg2rad(-25.0), deg2rad(40.0));
+	const Vector4_64 offset_translation = vector_set(0.5, -1.0, 2.0);
+
+	for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
 	{
-		const char* argument = argv[arg_index];
+		const AnimatedBone& bone = clip.get_animated_bone(bone_index);
+		AnimatedBone& offset_bone = offset_clip.get_bones()[bone_index];
 
-		size_t option_length = std::strlen(ACL_INPUT_FILE_OPTION);
-		if (std::strncmp(argument, ACL_INPUT_FILE_OPTION, option_length) == 0)
+		for (uint32_t sample_index = 0; sample_index < num_samples; ++sample_index)
 		{
-			options.input_filename = argument + option_length;
-			continue;
+			offset_bone.rotation_track.set_sample(sample_index, quat_normalize(quat_mul(bone.rotation_track.get_sample(sample_index), offset_rotation)));
+			offset_bone.translation_track.set_sample(sample_index, vector_add(bone.translation_track.get_sample(sample_index), offset_translation));
 		}
+	}
 
-		option_length = std::strlen(STATS_OUTPUT_OPTION);
-		if (std::strncmp(argument, STATS_OUTPUT_OPTION, option_length) == 0)
+	OutputStats stats;
+	return algorithm.compress_clip(allocator, offset_clip, skeleton, stats);
+}
+
+// Blending decompresses both clips in turn, a bone must match the lerp of both poses and the ends must
+// match either pose exactly since the other clip is skipped
+static void validate_blended_pose(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, const CompressedClip& other_compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+	float clip_duration = clip.get_duration();
+
+	DecompressionSettings settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* other_context = allocate_decompression_context(allocator, settings, other_compressed_clip);
+	Transform_32* pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* other_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	float* bone_weights = allocate_type_array<float>(allocator, num_bones);
+
+	// Every third bone comes entirely from either clip
+	for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+		bone_weights[bone_index] = float(bone_index % 3) * 0.5f;
+
+	for_each_validation_sample_time(clip, [&](float sample_time)
+	{
+		// The second clip plays backward to blend different poses
+		const float other_sample_time = clip_duration - sample_time;
+
+		DefaultOutputWriter pose_writer(pose_transforms, num_bones);
+		decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+		DefaultOutputWriter other_pose_writer(other_pose_transforms, num_bones);
+		decompress_pose(settings, other_compressed_clip, other_context, other_sample_time, other_pose_writer);
+
+		const float blend_weights[] = { 0.0f, 0.3f, 1.0f };
+		for (float blend_weight : blend_weights)
 		{
-			options.output_stats = true;
-			if (argument[option_length] == '=')
+			for (int32_t use_bone_weights = 0; use_bone_weights < 2; ++use_bone_weights)
 			{
-				options.output_stats_filename = argument + option_length + 1;
-				size_t filename_len = std::strlen(options.output_stats_filename);
-				if (filename_len < 6 || strncmp(options.output_stats_filename + filename_len - 6, ".sjson", 6) != 0)
+				DefaultOutputWriter blended_pose_writer(lossy_pose_transforms, num_bones);
+				decompress_blended_pose(settings, compressed_clip, context, sample_time, other_compressed_clip, other_context, other_sample_time, blend_weight, use_bone_weights != 0 ? bone_weights : nullptr, blended_pose_writer);
+
+				for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
 				{
-					printf("Stats output file must be an SJSON file.\n");
-					return false;
+					const float bone_weight = use_bone_weights != 0 ? (blend_weight * bone_weights[bone_index]) : blend_weight;
+					const Transform_32& transform = pose_transforms[bone_index];
+					const Transform_32& other_transform = other_pose_transforms[bone_index];
+
+					Transform_32 expected_transform;
+					if (bone_weight == 0.0f)
+						expected_transform = transform;
+					else if (bone_weight == 1.0f)
+						expected_transform = other_transform;
+					else
+						expected_transform = transform_set(quat_lerp(transform.rotation, other_transform.rotation, bone_weight), vector_lerp(transform.translation, other_transform.translation, bone_weight));
+
+					ACL_ENSURE(std::memcmp(&lossy_pose_transforms[bone_index].rotation, &expected_transform.rotation, sizeof(Quat_32)) == 0, "Blended pose: rotation mismatch for bone %u at time %f with weight %f", bone_index, sample_time, bone_weight);
+					ACL_ENSURE(std::memcmp(&lossy_pose_transforms[bone_index].translation, &expected_transform.translation, sizeof(float) * 3) == 0, "Blended pose: translation mismatch for bone %u at time %f with weight %f", bone_index, sample_time, bone_weight);
 				}
 			}
-			else
-				options.output_stats_filename = nullptr;
+		}
+	});
 
-			options.open_output_stats_file();
+	deallocate_type_array(allocator, bone_weights, num_bones);
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, other_pose_transforms, num_bones);
+	deallocate_type_array(allocator, pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, other_context);
+	deallocate_decompression_context(allocator, context);
+}
+
+// Every context caches the constant tracks of its own clip, decompressing two clips with several contexts
+// in turn must produce the same poses as without the cache
+static void validate_constant_track_cache(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, const CompressedClip& other_compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	// Two contexts for the first clip and one for the second clip
+	const CompressedClip* compressed_clips[] = { &compressed_clip, &other_compressed_clip, &compressed_clip };
+	const uint32_t num_contexts = 3;
+
+	DecompressionSettings settings;
+	ConstantTrackCacheDecompressionSettings constant_cache_settings;
+	void* contexts[num_contexts];
+	void* constant_cache_contexts[num_contexts];
+	for (uint32_t context_index = 0; context_index < num_contexts; ++context_index)
+	{
+		contexts[context_index] = allocate_decompression_context(allocator, settings, *compressed_clips[context_index]);
+		constant_cache_contexts[context_index] = allocate_decompression_context(allocator, constant_cache_settings, *compressed_clips[context_index]);
+	}
+
+	Transform_32* reference_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+
+	for_each_validation_sample_time(clip, [&](float sample_time)
+	{
+		for (uint32_t context_index = 0; context_index < num_contexts; ++context_index)
+		{
+			const CompressedClip& context_compressed_clip = *compressed_clips[context_index];
+
+			DefaultOutputWriter reference_pose_writer(reference_pose_transforms, num_bones);
+			decompress_pose(settings, context_compressed_clip, contexts[context_index], sample_time, reference_pose_writer);
+
+			DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(constant_cache_settings, context_compressed_clip, constant_cache_contexts[context_index], sample_time, pose_writer);
+			validate_poses_match(lossy_pose_transforms, reference_pose_transforms, num_bones, sample_time, "Constant track cache");
+
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			{
+				Quat_32 rotation;
+				Vector4_32 translation;
+				decompress_bone(constant_cache_settings, context_compressed_clip, constant_cache_contexts[context_index], sample_time, bone_index, &rotation, &translation);
+				ACL_ENSURE(std::memcmp(&rotation, &reference_pose_transforms[bone_index].rotation, sizeof(Quat_32)) == 0, "Constant track cache: rotation mismatch for bone %u at time %f", bone_index, sample_time);
+				ACL_ENSURE(std::memcmp(&translation, &reference_pose_transforms[bone_index].translation, sizeof(float) * 3) == 0, "Constant track cache: translation mismatch for bone %u at time %f", bone_index, sample_time);
+			}
+		}
+	});
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, reference_pose_transforms, num_bones);
+	for (uint32_t context_index = 0; context_index < num_contexts; ++context_index)
+	{
+		deallocate_decompression_context(allocator, constant_cache_contexts[context_index]);
+		deallocate_decompression_context(allocator, contexts[context_index]);
+	}
+}
+
+// A persistent pose only skips the invariant tracks while the same clip keeps being decompressed into it,
+// switching clips or resetting the writer must write the whole pose again
+static void validate_persistent_pose(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, const CompressedClip& other_compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	const uint32_t bitset_size = get_bitset_size(num_bones * uniformly_sampled::impl::Constants::NUM_TRACKS_PER_BONE);
+
+	DecompressionSettings settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* other_context = allocate_decompression_context(allocator, settings, other_compressed_clip);
+	void* reference_context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* other_reference_context = allocate_decompression_context(allocator, settings, other_compressed_clip);
+	Transform_32* reference_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+
+	// Written before every decompression into the tracks that must be written, it is not a valid transform
+	const Transform_32 untouched_transform = transform_set(quat_set(2.0f, 2.0f, 2.0f, 2.0f), vector_set(-1.0f));
+
+	PersistentPoseOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+
+	const CompressedClip* previous_compressed_clip = nullptr;
+	uint32_t frame_index = 0;
+	for_each_validation_sample_time(clip, [&](float sample_time)
+	{
+		// Switch clips every few frames and reset the writer now and then
+		const bool use_other_clip = ((frame_index / 4) % 2) != 0;
+		const bool reset_writer = (frame_index % 7) == 3;
+		frame_index++;
+
+		const CompressedClip& frame_compressed_clip = use_other_clip ? other_compressed_clip : compressed_clip;
+		const uniformly_sampled::impl::ClipHeader& header = uniformly_sampled::impl::get_clip_header(frame_compressed_clip);
+		const uint32_t* default_tracks_bitset = header.get_default_tracks_bitset();
+		const uint32_t* constant_tracks_bitset = header.get_constant_tracks_bitset();
+
+		DefaultOutputWriter reference_pose_writer(reference_pose_transforms, num_bones);
+		decompress_pose(settings, frame_compressed_clip, use_other_clip ? other_reference_context : reference_context, sample_time, reference_pose_writer);
+
+		// Something else modified the pose, every track must be written again
+		if (reset_writer)
+			pose_writer.reset();
+
+		// Only the same clip as the previous decompression, without a reset in between, can skip its invariant tracks
+		pose_writer.begin_pose(frame_compressed_clip);
+		const bool can_skip_invariant_tracks = pose_writer.skip_constant_bone_tracks();
+		ACL_ENSURE(can_skip_invariant_tracks == (!reset_writer && previous_compressed_clip == &frame_compressed_clip), "Persistent pose: invalid invariant track state at time %f", sample_time);
+		previous_compressed_clip = &frame_compressed_clip;
+
+		// Animated tracks are always written again, invariant tracks keep the value from the previous decompression
+		// when it can be reused, otherwise the whole pose is written
+		if (can_skip_invariant_tracks)
+		{
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			{
+				const uint32_t rotation_track_index = bone_index * uniformly_sampled::impl::Constants::NUM_TRACKS_PER_BONE;
+				if (!bitset_test(default_tracks_bitset, bitset_size, rotation_track_index) && !bitset_test(constant_tracks_bitset, bitset_size, rotation_track_index))
+					lossy_pose_transforms[bone_index].rotation = untouched_transform.rotation;
+				if (!bitset_test(default_tracks_bitset, bitset_size, rotation_track_index + 1) && !bitset_test(constant_tracks_bitset, bitset_size, rotation_track_index + 1))
+					lossy_pose_transforms[bone_index].translation = untouched_transform.translation;
+			}
+		}
+		else
+		{
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+				lossy_pose_transforms[bone_index] = untouched_transform;
+		}
+
+		decompress_pose(settings, frame_compressed_clip, use_other_clip ? other_context : context, sample_time, pose_writer);
+		validate_poses_match(lossy_pose_transforms, reference_pose_transforms, num_bones, sample_time, "Persistent pose");
+	});
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, reference_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, other_reference_context);
+	deallocate_decompression_context(allocator, reference_context);
+	deallocate_decompression_context(allocator, other_context);
+	deallocate_decompression_context(allocator, context);
+}
+
+// An additive pose must be composed with the base pose like the two pass version does, default tracks
+// must leave the base pose untouched, and so must a zero weight, also when instances are batched
+static void validate_additive_pose(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip, const CompressedClip& additive_compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	const uniformly_sampled::impl::ClipHeader& additive_header = uniformly_sampled::impl::get_clip_header(additive_compressed_clip);
+	const uint32_t* default_tracks_bitset = additive_header.get_default_tracks_bitset();
+	const uint32_t bitset_size = get_bitset_size(num_bones * uniformly_sampled::impl::Constants::NUM_TRACKS_PER_BONE);
+
+	DecompressionSettings settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* additive_context = allocate_decompression_context(allocator, settings, additive_compressed_clip);
+	Transform_32* base_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* additive_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+
+	// Batched instances with mixed weights, the first one doesn't contribute to make sure the others still do
+	const float instance_additive_weights[] = { 0.0f, 1.0f, 0.5f, 0.0f };
+	const uint32_t num_instances = 4;
+	void* instance_contexts[num_instances];
+	float instance_sample_times[num_instances];
+	Transform_32* instance_pose_transforms = allocate_type_array<Transform_32>(allocator, size_t(num_instances) * num_bones);
+	for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+		instance_contexts[instance_index] = allocate_decompression_context(allocator, settings, additive_compressed_clip);
+
+	for_each_validation_sample_time(clip, [&](float sample_time)
+	{
+		DefaultOutputWriter base_pose_writer(base_pose_transforms, num_bones);
+		decompress_pose(settings, compressed_clip, context, sample_time, base_pose_writer);
+		DefaultOutputWriter additive_pose_writer(additive_pose_transforms, num_bones);
+		decompress_pose(settings, additive_compressed_clip, additive_context, sample_time, additive_pose_writer);
+
+		const float additive_weights[] = { 0.0f, 0.5f, 1.0f };
+		for (float additive_weight : additive_weights)
+		{
+			std::memcpy(lossy_pose_transforms, base_pose_transforms, sizeof(Transform_32) * num_bones);
+
+			AdditiveOutputWriter pose_writer(lossy_pose_transforms, num_bones, additive_weight);
+			decompress_pose(settings, additive_compressed_clip, additive_context, sample_time, pose_writer);
+
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			{
+				const Transform_32& base_transform = base_pose_transforms[bone_index];
+				const Transform_32& additive_transform = additive_pose_transforms[bone_index];
+				const uint32_t rotation_track_index = bone_index * uniformly_sampled::impl::Constants::NUM_TRACKS_PER_BONE;
+				const uint32_t translation_track_index = rotation_track_index + 1;
+
+				Transform_32 expected_transform = base_transform;
+				if (additive_weight != 0.0f && !bitset_test(default_tracks_bitset, bitset_size, rotation_track_index))
+				{
+					const Quat_32 additive_rotation = additive_weight == 1.0f ? additive_transform.rotation : quat_lerp(quat_identity_32(), additive_transform.rotation, additive_weight);
+					expected_transform.rotation = quat_normalize(quat_mul(additive_rotation, base_transform.rotation));
+				}
+				if (additive_weight != 0.0f && !bitset_test(default_tracks_bitset, bitset_size, translation_track_index))
+					expected_transform.translation = vector_add(base_transform.translation, vector_mul(additive_transform.translation, additive_weight));
+
+				ACL_ENSURE(std::memcmp(&lossy_pose_transforms[bone_index].rotation, &expected_transform.rotation, sizeof(Quat_32)) == 0, "Additive pose: rotation mismatch for bone %u at time %f with weight %f", bone_index, sample_time, additive_weight);
+				ACL_ENSURE(std::memcmp(&lossy_pose_transforms[bone_index].translation, &expected_transform.translation, sizeof(float) * 3) == 0, "Additive pose: translation mismatch for bone %u at time %f with weight %f", bone_index, sample_time, additive_weight);
+			}
+		}
+
+		std::vector<AdditiveOutputWriter> instance_writers;
+		for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+		{
+			Transform_32* pose_transforms = instance_pose_transforms + (instance_index * num_bones);
+			std::memcpy(pose_transforms, base_pose_transforms, sizeof(Transform_32) * num_bones);
+			instance_writers.push_back(AdditiveOutputWriter(pose_transforms, num_bones, instance_additive_weights[instance_index]));
+			instance_sample_times[instance_index] = sample_time;
+		}
+
+		decompress_poses(settings, additive_compressed_clip, instance_contexts, instance_sample_times, instance_writers.data(), num_instances);
+
+		// Every instance must match decompressing it on its own
+		for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+		{
+			std::memcpy(lossy_pose_transforms, base_pose_transforms, sizeof(Transform_32) * num_bones);
+
+			AdditiveOutputWriter pose_writer(lossy_pose_transforms, num_bones, instance_additive_weights[instance_index]);
+			decompress_pose(settings, additive_compressed_clip, additive_context, sample_time, pose_writer);
+			validate_poses_match(instance_pose_transforms + (instance_index * num_bones), lossy_pose_transforms, num_bones, sample_time, "Batched additive pose");
+		}
+	});
+
+	for (uint32_t instance_index = 0; instance_index < num_instances; ++instance_index)
+		deallocate_decompression_context(allocator, instance_contexts[instance_index]);
+	deallocate_type_array(allocator, instance_pose_transforms, size_t(num_instances) * num_bones);
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, additive_pose_transforms, num_bones);
+	deallocate_type_array(allocator, base_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, additive_context);
+	deallocate_decompression_context(allocator, context);
+}
+
+// Sampling a few bones at many unsorted times must match sampling every bone at every time on its own,
+// enough times are requested to be sorted in several groups
+static void validate_bones_at_times(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	std::vector<float> sample_times;
+	const std::vector<float> playback_sample_times = get_playback_sample_times(clip, compressed_clip);
+	while (sample_times.size() <= uniformly_sampled::impl::NUM_SORTED_SAMPLE_TIMES * 2)
+		sample_times.insert(sample_times.end(), playback_sample_times.begin(), playback_sample_times.end());
+
+	// Every other bone
+	std::vector<uint16_t> bone_indices;
+	for (uint16_t bone_index = 0; bone_index < num_bones; bone_index += 2)
+		bone_indices.push_back(bone_index);
+
+	const uint16_t num_masked_bones = uint16_t(bone_indices.size());
+	const uint32_t num_sample_times = uint32_t(sample_times.size());
+
+	DecompressionSettings settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* reference_context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* bone_mask = allocate_bone_mask(allocator, settings, compressed_clip, bone_indices.data(), num_masked_bones);
+	std::vector<Transform_32> lossy_transforms(size_t(num_sample_times) * num_masked_bones);
+
+	decompress_bones_at_times(settings, compressed_clip, context, bone_mask, sample_times.data(), num_sample_times, lossy_transforms.data());
+
+	for (uint32_t time_index = 0; time_index < num_sample_times; ++time_index)
+	{
+		const float sample_time = sample_times[time_index];
+		for (uint16_t mask_index = 0; mask_index < num_masked_bones; ++mask_index)
+		{
+			const uint16_t bone_index = bone_indices[mask_index];
+			const Transform_32& transform = lossy_transforms[(time_index * num_masked_bones) + mask_index];
+
+			Quat_32 rotation;
+			Vector4_32 translation;
+			decompress_bone(settings, compressed_clip, reference_context, sample_time, bone_index, &rotation, &translation);
+			ACL_ENSURE(std::memcmp(&transform.rotation, &rotation, sizeof(Quat_32)) == 0, "Bones at times: rotation mismatch for bone %u at time %f", bone_index, sample_time);
+			ACL_ENSURE(std::memcmp(&transform.translation, &translation, sizeof(float) * 3) == 0, "Bones at times: translation mismatch for bone %u at time %f", bone_index, sample_time);
+		}
+	}
+
+	deallocate_bone_mask(allocator, bone_mask);
+	deallocate_decompression_context(allocator, reference_context);
+	deallocate_decompression_context(allocator, context);
+}
+
+// Applying the root motion delta onto the root at the start time must give the root at the end time,
+// wrapping around the end of a looping clip adds the motion from the start time up to the end of the clip
+static void validate_root_motion(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	float clip_duration = clip.get_duration();
+
+	DecompressionSettings settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* reference_context = allocate_decompression_context(allocator, settings, compressed_clip);
+
+	auto decompress_root = [&](float sample_time)
+	{
+		Transform_32 transform;
+		decompress_bone(settings, compressed_clip, reference_context, sample_time, 0, &transform.rotation, &transform.translation);
+		return transform;
+	};
+
+	const Transform_32 first_transform = decompress_root(0.0f);
+	const Transform_32 last_transform = decompress_root(clip_duration);
+
+	for_each_validation_sample_time(clip, [&](float start_sample_time)
+	{
+		const Transform_32 start_transform = decompress_root(start_sample_time);
+
+		// Forward, backward, and wrapping around
+		const float end_sample_times[] = { min(start_sample_time + (clip_duration / 3.0f), clip_duration), max(start_sample_time - (clip_duration / 4.0f), 0.0f), start_sample_time * 0.5f };
+		for (uint32_t end_index = 0; end_index < 3; ++end_index)
+		{
+			const float end_sample_time = end_sample_times[end_index];
+			const bool is_looping = end_index == 2;
+			if (is_looping && end_sample_time >= start_sample_time)
+				continue;
+
+			const Transform_32 end_transform = decompress_root(end_sample_time);
+			const Transform_32 expected_transform = is_looping ? transform_mul(transform_mul(end_transform, transform_inverse(first_transform)), last_transform) : end_transform;
+
+			const Transform_32 delta = decompress_root_motion_delta(settings, compressed_clip, context, start_sample_time, end_sample_time, is_looping);
+			const Transform_32 transform = transform_mul(delta, start_transform);
+
+			ACL_ENSURE(quat_near_equal(transform.rotation, expected_transform.rotation, 0.0001f), "Root motion: rotation mismatch from time %f to time %f", start_sample_time, end_sample_time);
+			ACL_ENSURE(vector_near_equal3(transform.translation, expected_transform.translation, 0.001f), "Root motion: translation mismatch from time %f to time %f", start_sample_time, end_sample_time);
+		}
+	});
+
+	deallocate_decompression_context(allocator, reference_context);
+	deallocate_decompression_context(allocator, context);
+}
+
+struct FloorKeyDecompressionSettings : public uniformly_sampled::DecompressionSettings
+{
+	constexpr uniformly_sampled::SamplingMode8 get_sampling_mode() const { return uniformly_sampled::SamplingMode8::Floor; }
+};
+
+// Sampling a single key frame must return exactly what interpolating at that key frame returns, with the
+// interpolation alpha at zero. Sample times are a quarter of a key frame away to pick a known key frame.
+static void validate_key_frame_sampling(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+	float clip_duration = clip.get_duration();
+	float sample_rate = float(clip.get_sample_rate());
+	uint32_t num_samples = calculate_num_samples(clip_duration, clip.get_sample_rate());
+
+	DecompressionSettings settings;
+	FloorKeyDecompressionSettings floor_key_settings;
+	NearestKeyDecompressionSettings nearest_key_settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* key_context = allocate_decompression_context(allocator, settings, compressed_clip);
+	Transform_32* reference_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+
+	for (uint32_t sample_index = 0; sample_index < num_samples; ++sample_index)
+	{
+		const float key_sample_time = min(float(sample_index) / sample_rate, clip_duration);
+
+		// The key frame time can round to the end of the previous key frame, interpolation then isn't exact
+		uint32_t key_frame0;
+		uint32_t key_frame1;
+		float interpolation_alpha;
+		calculate_interpolation_keys(num_samples, clip_duration, key_sample_time, key_frame0, key_frame1, interpolation_alpha);
+		if (key_frame0 != sample_index || interpolation_alpha != 0.0f)
 			continue;
+
+		DefaultOutputWriter reference_pose_writer(reference_pose_transforms, num_bones);
+		decompress_pose(settings, compressed_clip, context, key_sample_time, reference_pose_writer);
+
+		const float before_sample_time = max(key_sample_time - (0.25f / sample_rate), 0.0f);
+		const float after_sample_time = min(key_sample_time + (0.25f / sample_rate), clip_duration);
+
+		{
+			DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(floor_key_settings, compressed_clip, key_context, key_sample_time, pose_writer);
+			validate_poses_match(lossy_pose_transforms, reference_pose_transforms, num_bones, key_sample_time, "Floor key");
 		}
 
-		printf("Unrecognized option %s\n", argument);
-		return false;
+		if (sample_index + 1 < num_samples)
+		{
+			DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(floor_key_settings, compressed_clip, key_context, after_sample_time, pose_writer);
+			validate_poses_match(lossy_pose_transforms, reference_pose_transforms, num_bones, after_sample_time, "Floor key");
+		}
+
+		const float nearest_sample_times[] = { before_sample_time, key_sample_time, after_sample_time };
+		for (float nearest_sample_time : nearest_sample_times)
+		{
+			DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+			decompress_pose(nearest_key_settings, compressed_clip, key_context, nearest_sample_time, pose_writer);
+			validate_poses_match(lossy_pose_transforms, reference_pose_transforms, num_bones, nearest_sample_time, "Nearest key");
+		}
 	}
 
-	if (options.input_filename == nullptr || std::strlen(options.input_filename) == 0)
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, reference_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, key_context);
+	deallocate_decompression_context(allocator, context);
+}
+
+// The decode plan visits the tracks grouped by kind instead of in bone order, it must produce the same poses
+static void validate_decode_plan(Allocator& allocator, const AnimationClip& clip, const CompressedClip& compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	DecompressionSettings settings;
+	DecodePlanDecompressionSettings decode_plan_settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* decode_plan_context = allocate_decompression_context(allocator, decode_plan_settings, compressed_clip);
+	Transform_32* reference_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+
+	for_each_validation_sample_time(clip, [&](float sample_time)
 	{
-		printf("An input file is required.\n");
-		return false;
+		DefaultOutputWriter reference_pose_writer(reference_pose_transforms, num_bones);
+		decompress_pose(settings, compressed_clip, context, sample_time, reference_pose_writer);
+
+		DefaultOutputWriter pose_writer(lossy_pose_transforms, num_bones);
+		decompress_pose(decode_plan_settings, compressed_clip, decode_plan_context, sample_time, pose_writer);
+		validate_poses_match(lossy_pose_transforms, reference_pose_transforms, num_bones, sample_time, "Decode plan");
+	});
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, reference_pose_transforms, num_bones);
+	deallocate_decompression_context(allocator, decode_plan_context);
+	deallocate_decompression_context(allocator, context);
+}
+
+// Composing each bone with its parent as it is decompressed must match converting the whole pose afterwards,
+// the decoder must also write the bones in order when the settings ask for a decode plan
+static void validate_object_space_pose(Allocator& allocator, const AnimationClip& clip, const RigidSkeleton& skeleton, const CompressedClip& compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	DecompressionSettings settings;
+	DecodePlanDecompressionSettings decode_plan_settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	void* decode_plan_context = allocate_decompression_context(allocator, decode_plan_settings, compressed_clip);
+	uint16_t* parent_indices = allocate_parent_indices(allocator, skeleton);
+	Transform_32* reference_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* lossy_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+
+	for_each_validation_sample_time(clip, [&](float sample_time)
+	{
+		DefaultOutputWriter reference_pose_writer(reference_pose_transforms, num_bones);
+		decompress_pose(settings, compressed_clip, context, sample_time, reference_pose_writer);
+		local_to_object_space(skeleton, reference_pose_transforms, reference_pose_transforms);
+
+		for (int32_t use_decode_plan = 0; use_decode_plan < 2; ++use_decode_plan)
+		{
+			ObjectSpaceOutputWriter pose_writer(parent_indices, lossy_pose_transforms, num_bones);
+			if (use_decode_plan != 0)
+				decompress_pose(decode_plan_settings, compressed_clip, decode_plan_context, sample_time, pose_writer);
+			else
+				decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+
+			// The writer only normalizes the rotations that drifted, the values differ slightly down long chains
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			{
+				ACL_ENSURE(quat_near_equal(lossy_pose_transforms[bone_index].rotation, reference_pose_transforms[bone_index].rotation, 0.0001f), "Object space pose: rotation mismatch for bone %u at time %f", bone_index, sample_time);
+				ACL_ENSURE(vector_near_equal3(lossy_pose_transforms[bone_index].translation, reference_pose_transforms[bone_index].translation, 0.001f), "Object space pose: translation mismatch for bone %u at time %f", bone_index, sample_time);
+			}
+		}
+	});
+
+	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
+	deallocate_type_array(allocator, reference_pose_transforms, num_bones);
+	deallocate_type_array(allocator, parent_indices, num_bones);
+	deallocate_decompression_context(allocator, decode_plan_context);
+	deallocate_decompression_context(allocator, context);
+}
+
+// Transforms a position with the 3 rows of a 3x4 matrix
+static Vector4_32 matrix3x4_mul_position(const float* matrix, const Vector4_32& position)
+{
+	const Vector4_32 point = vector_set(vector_get_x(position), vector_get_y(position), vector_get_z(position), 1.0f);
+	return vector_set(vector_dot(vector_unaligned_load(matrix + 0), point), vector_dot(vector_unaligned_load(matrix + 4), point), vector_dot(vector_unaligned_load(matrix + 8), point));
+}
+
+// Skinning matrices, from both the SIMD and the scalar conversions and from the output writer, must transform
+// positions like the object space pose combined with the inverse bind pose
+static void validate_skinning_matrices(Allocator& allocator, const AnimationClip& clip, const RigidSkeleton& skeleton, const CompressedClip& compressed_clip)
+{
+	using namespace uniformly_sampled;
+
+	uint16_t num_bones = clip.get_num_bones();
+
+	DecompressionSettings settings;
+	void* context = allocate_decompression_context(allocator, settings, compressed_clip);
+	uint16_t* parent_indices = allocate_parent_indices(allocator, skeleton);
+	Transform_32* object_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* writer_object_pose_transforms = allocate_type_array<Transform_32>(allocator, num_bones);
+	Transform_32* inverse_bind_pose = allocate_type_array<Transform_32>(allocator, num_bones);
+	float* skinning_matrices = allocate_type_array_aligned<float>(allocator, size_t(num_bones) * Matrix3x4OutputWriter::NUM_FLOATS_PER_MATRIX, 16);
+
+	// Any pose works as a bind pose, use the first one in object space
+	{
+		DefaultOutputWriter pose_writer(inverse_bind_pose, num_bones);
+		decompress_pose(settings, compressed_clip, context, 0.0f, pose_writer);
+		local_to_object_space(skeleton, inverse_bind_pose, inverse_bind_pose);
+		for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			inverse_bind_pose[bone_index] = transform_inverse(inverse_bind_pose[bone_index]);
 	}
 
-	return true;
+	const Vector4_32 positions[] = { vector_zero_32(), vector_set(1.0f, 0.0f, 0.0f), vector_set(0.0f, -2.5f, 0.5f), vector_set(-12.0f, 7.0f, 31.0f) };
+
+	for_each_validation_sample_time(clip, [&](float sample_time)
+	{
+		DefaultOutputWriter pose_writer(object_pose_transforms, num_bones);
+		decompress_pose(settings, compressed_clip, context, sample_time, pose_writer);
+		local_to_object_space(skeleton, object_pose_transforms, object_pose_transforms);
+
+		for (int32_t use_inverse_bind_pose = 0; use_inverse_bind_pose < 2; ++use_inverse_bind_pose)
+		{
+			{
+				Matrix3x4OutputWriter matrix_writer(parent_indices, writer_object_pose_transforms, skinning_matrices, num_bones, use_inverse_bind_pose != 0 ? inverse_bind_pose : nullptr);
+				decompress_pose(settings, compressed_clip, context, sample_time, matrix_writer);
+			}
+
+			for (uint16_t bone_index = 0; bone_index < num_bones; ++bone_index)
+			{
+				const Transform_32 transform = use_inverse_bind_pose != 0 ? transform_mul(inverse_bind_pose[bone_index], object_pose_transforms[bone_index]) : object_pose_transforms[bone_index];
+
+				float matrix[Matrix3x4OutputWriter::NUM_FLOATS_PER_MATRIX];
+				float scalar_matrix[Matrix3x4OutputWriter::NUM_FLOATS_PER_MATRIX];
+				Vector4_32 rows[3];
+				matrix3x4_from_rotation_translation(transform.rotation, transform.translation, rows[0], rows[1], rows[2]);
+				for (uint32_t row_index = 0; row_index < 3; ++row_index)
+					vector_unaligned_write(rows[row_index], matrix + (row_index * 4));
+				matrix3x4_from_rotation_translation_scalar(transform.rotation, transform.translation, rows[0], rows[1], rows[2]);
+				for (uint32_t row_index = 0; row_index < 3; ++row_index)
+					vector_unaligned_write(rows[row_index], scalar_matrix + (row_index * 4));
+
+				// The writer composes the object space pose itself, it only normalizes the rotations that drifted
+				const float* writer_matrix = skinning_matrices + (bone_index * Matrix3x4OutputWriter::NUM_FLOATS_PER_MATRIX);
+				for (const Vector4_32& position : positions)
+				{
+					const Vector4_32 expected_position = transform_position(transform, position);
+					ACL_ENSURE(vector_near_equal3(matrix3x4_mul_position(matrix, position), expected_position, 0.001f), "Skinning matrix mismatch for bone %u at time %f", bone_index, sample_time);
+					ACL_ENSURE(vector_near_equal3(matrix3x4_mul_position(scalar_matrix, position), expected_position, 0.001f), "Scalar skinning matrix mismatch for bone %u at time %f", bone_index, sample_time);
+					ACL_ENSURE(vector_near_equal3(matrix3x4_mul_position(writer_matrix, position), expected_position, 0.01f), "Skinning matrix writer mismatch for bone %u at time %f", bone_index, sample_time);
+				}
+			}
+		}
+	});
+
+	deallocate_type_array(allocator, skinning_matrices, size_t(num_bones) * Matrix3x4OutputWriter::NUM_FLOATS_PER_MATRIX);
+	deallocate_type_array(allocator, inverse_bind_pose, num_bones);
+	deallocate_type_array(allocator, writer_object_pose_transforms, num_bones);
+	deallocate_type_array(allocator, object_pose_transforms, num_bones);
+	deallocate_type_array(allocator, parent_indices, num_bones);
+	deallocate_decompression_context(allocator, context);
 }
 
 static void unit_test(Allocator& allocator, const AnimationClip& clip, const RigidSkeleton& skeleton, const CompressedClip& compressed_clip, IAlgorithm& algorithm)
@@ -182,6 +2051,33 @@ static void unit_test(Allocator& allocator, const AnimationClip& clip, const Rig
 		ACL_ENSURE(vector_near_equal3(test_translation, lossy_pose_transforms[sample_bone_index].translation), "Failed to sample bone index: %u", sample_bone_index);
 	}
 
+	validate_variable_unpacking();
+
+	if (compressed_clip.get_algorithm_type() == AlgorithmType8::UniformlySampled)
+	{
+		validate_decode_plan(allocator, clip, compressed_clip);
+		validate_playback(allocator, clip, compressed_clip, PlaybackCursorDecompressionSettings(), "Playback cursor");
+		validate_playback(allocator, clip, compressed_clip, KeyFrameCacheDecompressionSettings(), "Key frame cache");
+		validate_shared_context(allocator, clip, compressed_clip, uniformly_sampled::DecompressionSettings(), "Shared context");
+		validate_shared_context(allocator, clip, compressed_clip, PlaybackCursorDecompressionSettings(), "Shared context playback cursor");
+		validate_partial_pose(allocator, clip, compressed_clip);
+		validate_object_space_pose(allocator, clip, skeleton, compressed_clip);
+		validate_skinning_matrices(allocator, clip, skeleton, compressed_clip);
+		validate_bones_at_times(allocator, clip, compressed_clip);
+		validate_root_motion(allocator, clip, compressed_clip);
+		validate_key_frame_sampling(allocator, clip, compressed_clip);
+
+		CompressedClip* offset_compressed_clip = compress_offset_clip(allocator, clip, skeleton, algorithm);
+		validate_blended_pose(allocator, clip, compressed_clip, *offset_compressed_clip);
+		validate_constant_track_cache(allocator, clip, compressed_clip, *offset_compressed_clip);
+		validate_persistent_pose(allocator, clip, compressed_clip, *offset_compressed_clip);
+		allocator.deallocate(offset_compressed_clip, offset_compressed_clip->get_size());
+
+		CompressedClip* additive_compressed_clip = compress_additive_clip(allocator, clip, skeleton, algorithm);
+		validate_additive_pose(allocator, clip, compressed_clip, *additive_compressed_clip);
+		allocator.deallocate(additive_compressed_clip, additive_compressed_clip->get_size());
+	}
+
 	deallocate_type_array(allocator, raw_pose_transforms, num_bones);
 	deallocate_type_array(allocator, lossy_pose_transforms, num_bones);
 	algorithm.deallocate_decompression_context(allocator, context);
@@ -198,6 +2094,9 @@ static void try_algorithm(const Options& options, Allocator& allocator, const An
 
 		unit_test(allocator, clip, skeleton, *compressed_clip, algorithm);
 
+		if (options.benchmark && stats_writer != nullptr)
+			benchmark_decompression(allocator, clip, skeleton, *compressed_clip, algorithm, *stats_writer);
+
 		allocator.deallocate(compressed_clip, compressed_clip->get_size());
 	};
 
@@ -323,6 +2222,12 @@ static int main_impl(int argc, char** argv)
 		SJSONWriter writer(stream_writer);
 
 		writer["runs"] = [&](SJSONArrayWriter& writer) { exec_algos(&writer); };
+
+		if (options.benchmark)
+		{
+			writer["parallel_quantization"] = [&](SJSONArrayWriter& writer) { benchmark_parallel_quantization(allocator, *clip.get(), *skeleton.get(), writer); };
+			writer["object_bone_error"] = [&](SJSONArrayWriter& writer) { benchmark_object_bone_error(allocator, writer); };
+		}
 	}
 	else
 		exec_algos(nullptr);